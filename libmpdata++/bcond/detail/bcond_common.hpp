@@ -8,6 +8,8 @@
 #include <libmpdata++/formulae/arakawa_c.hpp>
 #include <libmpdata++/formulae/idxperm.hpp>
 
+#include <vector>
+
 namespace libmpdataxx
 {
   namespace bcond
@@ -48,6 +50,12 @@ namespace libmpdataxx
           assert(false && "bcond::fill_halos_sclr() called!");
         };
 
+        // halos of several arrays filled at once (remote bconds pack them into a single message)
+        virtual void fill_halos_sclr_batch(const std::vector<arr_1d_t*> &av, const bool deriv = false)
+        {
+          for (auto a : av) fill_halos_sclr(*a, deriv);
+        };
+
         virtual void fill_halos_vctr_alng(arrvec_t<arr_1d_t> &, const bool ad = false)
         {
           assert(false && "bcond::fill_halos_vctr() called!");
@@ -62,6 +70,11 @@ namespace libmpdataxx
           assert(false && "bcond::fill_halos_sclr() called!");
         };
 
+        virtual void fill_halos_sclr_batch(const std::vector<arr_2d_t*> &av, const rng_t &j, const bool deriv = false)
+        {
+          for (auto a : av) fill_halos_sclr(*a, j, deriv);
+        };
+
         virtual void fill_halos_pres(arr_2d_t &, const rng_t &)
         {
           assert(false && "bcond::fill_halos_pres() called!");
@@ -117,6 +130,11 @@ namespace libmpdataxx
           assert(false && "bcond::fill_halos_sclr() called!");
         };
 
+        virtual void fill_halos_sclr_batch(const std::vector<arr_3d_t*> &av, const rng_t &j, const rng_t &k, const bool deriv = false)
+        {
+          for (auto a : av) fill_halos_sclr(*a, j, k, deriv);
+        };
+
         virtual void fill_halos_pres(arr_3d_t &, const rng_t &, const rng_t &)
         {
           assert(false && "bcond::fill_halos_pres() called!");
@@ -8,6 +8,16 @@
 #include <libmpdata++/blitz.hpp>
 #include <libmpdata++/bcond/detail/bcond_common.hpp>
 #include <libmpdata++/formulae/arakawa_c.hpp>
+#include <libmpdata++/concurr/detail/distmem.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if defined(USE_MPI)
+#  include <boost/mpi/communicator.hpp>
+#  include <boost/mpi/nonblocking.hpp>
+#endif
 
 namespace libmpdataxx
 {
@@ -32,6 +42,166 @@ namespace libmpdataxx
           return (j + pole) % (2 * pole);
         }
 
+        // (destination, source) pairs of indices along the boundary-normal dimension
+        using rows_t = std::vector<std::pair<int, int>>;
+
+        // a(dst, jj, k) = a(src, polar_neighbours(jj), k) for all rows and all jj in j,
+        // done with array expressions over the pieces of j that do not wrap around the pole
+        template <int d, class arr_t, class... ks_t>
+        void polar_copy_from(arr_t &dst, const arr_t &src, const rows_t &rows, const rng_t &j, const ks_t&... k)
+        {
+          using namespace idxperm;
+          for (int s = j.first(); s <= j.last();)
+          {
+            const int wrap = (s + pole) / (2 * pole);
+            const int e = std::min(j.last(), (wrap + 1) * 2 * pole - pole - 1);
+            const int shift = pole - wrap * 2 * pole;
+            for (const auto &r : rows)
+              dst(pi<d>(r.first, rng_t(s, e), k...)) = src(pi<d>(r.second, rng_t(s + shift, e + shift), k...));
+            s = e + 1;
+          }
+        }
+
+        // 2D: with the antipodal dimension divided among processes, the sources are
+        // first gathered from the processes owning them (see set_antipodes)
+        template <int d>
+        void polar_copy(blitz::Array<real_t, 2> &a, const rows_t &rows, const rng_t &j)
+        {
+#if defined(USE_MPI)
+          if (ranks.size() > 1) return polar_copy_from<d>(a, gather_antipodes<d>(a, rows), rows, j);
+#endif
+          polar_copy_from<d>(a, a, rows, j);
+        }
+
+        // 3D: single-process only (see concurr_common::bc_alloc)
+        template <int d>
+        void polar_copy(blitz::Array<real_t, 3> &a, const rows_t &rows, const rng_t &j, const rng_t &k)
+        {
+          polar_copy_from<d>(a, a, rows, j, k);
+        }
+
+#if defined(USE_MPI)
+        private:
+
+        const concurr::detail::distmem<real_t, n_dims> *dm = nullptr;
+        std::vector<int> ranks;       // processes sharing the pole, ordered along the antipodal dimension
+        int self = 0;                 // position of this process in ranks
+        std::vector<rng_t> proc_rngs, // antipodal-dimension range of each of the processes...
+                           thrd_rngs; // ... and of the counterpart of this thread in each of them
+        int tag = 0;
+        blitz::Array<real_t, 2> strip; // the rows near the pole along the whole antipodal dimension
+        std::vector<std::vector<real_t>> buf_send, buf_recv;
+
+        // the antipodes of the halo of a given thread range
+        std::vector<int> cols_needed(const rng_t &r)
+        {
+          std::vector<int> res;
+          for (int jj = r.first() - halo; jj <= r.last() + halo; ++jj) res.push_back(polar_neighbours(jj));
+          std::sort(res.begin(), res.end());
+          res.erase(std::unique(res.begin(), res.end()), res.end());
+          return res;
+        }
+
+        static bool owns(const rng_t &r, const int c)
+        {
+          return c >= r.first() && c <= r.last();
+        }
+
+        // exchanging the source rows with the processes sharing the pole, both sides
+        // deduce what is sent and received from the same ranges (hence no size messages)
+        template <int d>
+        const blitz::Array<real_t, 2> &gather_antipodes(const blitz::Array<real_t, 2> &a, const rows_t &rows)
+        {
+          using namespace idxperm;
+
+          std::vector<int> srcs;
+          for (const auto &r : rows) srcs.push_back(r.second);
+          std::sort(srcs.begin(), srcs.end());
+          srcs.erase(std::unique(srcs.begin(), srcs.end()), srcs.end());
+
+          const auto dom = pi<d>(rng_t(srcs.front(), srcs.back()), rng_t(0, 2 * pole - 1));
+          blitz::TinyVector<int, 2> lbound, extent;
+          bool fits = strip.size() > 0;
+          for (int n = 0; n < 2; ++n)
+          {
+            lbound(n) = dom.lbound(n);
+            extent(n) = dom.ubound(n) - dom.lbound(n) + 1;
+            fits = fits && strip.lbound(n) == lbound(n) && strip.extent(n) == extent(n);
+          }
+          if (!fits) strip.reference(blitz::Array<real_t, 2>(lbound, extent));
+
+          const auto mine = cols_needed(thrd_rngs[self]);
+          buf_send.resize(ranks.size());
+          buf_recv.resize(ranks.size());
+          for (int p = 0; p < int(ranks.size()); ++p)
+          {
+            buf_send[p].clear();
+            buf_recv[p].clear();
+            if (p == self) continue;
+            for (const int c : cols_needed(thrd_rngs[p]))
+              if (owns(proc_rngs[self], c))
+                for (const int s : srcs) buf_send[p].push_back(a(pi<d>(s, c)));
+            for (const int c : mine)
+              if (owns(proc_rngs[p], c))
+                buf_recv[p].resize(buf_recv[p].size() + srcs.size());
+          }
+
+          for (const int c : mine)
+            if (owns(proc_rngs[self], c))
+              for (const int s : srcs) strip(pi<d>(s, c)) = a(pi<d>(s, c));
+
+          std::vector<boost::mpi::request> reqs;
+          auto test_all = [&]{
+            for (auto &r : reqs) if (r.active() && !r.test()) return false;
+            return true;
+          };
+          dm->mpi_call(
+            [&]{
+              for (int p = 0; p < int(ranks.size()); ++p)
+              {
+                if (!buf_send[p].empty())
+                  reqs.push_back(dm->mpicom.isend(ranks[p], tag, buf_send[p].data(), buf_send[p].size()));
+                if (!buf_recv[p].empty())
+                  reqs.push_back(dm->mpicom.irecv(ranks[p], tag, buf_recv[p].data(), buf_recv[p].size()));
+              }
+            },
+            test_all,
+            [&]{ boost::mpi::wait_all(reqs.begin(), reqs.end()); }
+          );
+
+          for (int p = 0; p < int(ranks.size()); ++p)
+          {
+            auto v = buf_recv[p].begin();
+            if (p != self) for (const int c : mine)
+              if (owns(proc_rngs[p], c))
+                for (const int s : srcs) strip(pi<d>(s, c)) = *v++;
+          }
+          return strip;
+        }
+
+        public:
+
+        // called by concurr_common::bc_alloc if the antipodal dimension is divided among processes
+        void set_antipodes(
+          const concurr::detail::distmem<real_t, n_dims> *dm_,
+          const std::vector<int> &ranks_,
+          const int self_,
+          const std::vector<rng_t> &proc_rngs_,
+          const std::vector<rng_t> &thrd_rngs_,
+          const int chan,
+          const bool left
+        )
+        {
+          dm = dm_;
+          ranks = ranks_;
+          self = self_;
+          proc_rngs = proc_rngs_;
+          thrd_rngs = thrd_rngs_;
+          // above the tags used by the remote bconds
+          tag = (1 << 14) + 2 * chan + (left ? 0 : 1);
+        }
+#endif
+
         public:
 
         // ctor
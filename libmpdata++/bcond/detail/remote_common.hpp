@@ -6,11 +6,22 @@
 #pragma once
 
 #include <libmpdata++/bcond/detail/bcond_common.hpp>
+#include <libmpdata++/concurr/detail/distmem.hpp>
+
+#include <map>
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <vector>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
 
 #if defined(USE_MPI)
 #  include <boost/serialization/vector.hpp>
 #  include <boost/mpi/communicator.hpp>
 #  include <boost/mpi/nonblocking.hpp>
+#  include <boost/mpi/datatype.hpp>
 #endif
 
 namespace libmpdataxx
@@ -19,7 +30,7 @@ namespace libmpdataxx
   {
     namespace detail
     {
-      template <typename real_t, int halo, drctn_e dir, int n_dims>
+      template <typename real_t, int halo, drctn_e dir, int n_dims, int dim>
       class remote_common : public detail::bcond_common<real_t, halo, n_dims>
       {
         using parent_t = detail::bcond_common<real_t, halo, n_dims>;
@@ -31,12 +42,12 @@ namespace libmpdataxx
 
         private:
 
-        const int grid_size_0;
-
 #if defined(USE_MPI)
         boost::mpi::communicator mpicom;
         real_t *buf_send,
                *buf_recv;
+        std::size_t buf_size,       // number of elements needed for the halo of a single array
+                    buf_n_arrs = 1; // number of arrays the buffers are allocated for
 
 #  if defined(NDEBUG)
         static const int n_reqs = 2; // data, reqs for recv only is enough?
@@ -48,27 +59,254 @@ namespace libmpdataxx
 
         std::array<boost::mpi::request, n_reqs> reqs;
 
-        const int peer = dir == left
-          ? (mpicom.rank() - 1 + mpicom.size()) % mpicom.size()
-          : (mpicom.rank() + 1                ) % mpicom.size();
+        // neighbour in the process grid and the base of message tags
+        const int peer, tag;
 
 #  if !defined(NDEBUG)
           const int debug = 2;
           std::pair<int, int> buf_rng;
 #  endif
+
+        // halos of arrays in memory shared with the neighbour (same node, see sharedmem::old_shared)
+        // are read directly from the neighbour's memory, messages are used for synchronisation only
+        using dm_t = concurr::detail::distmem<real_t, n_dims>;
+        const dm_t *dm;
+        const int shm_peer;  // rank of the neighbour on the node, -1 if not sharing memory
+        const int shm_shift; // index shift between own halo and the corresponding neighbour's data
+        std::vector<const typename dm_t::shm_arr_t*> shm_tmp;
+
+        // MPI calls done directly or by the distmem communication thread (see distmem::mpi_call)
+        void mpi_call(
+          const std::function<void()> &post,
+          const std::function<bool()> &test,
+          const std::function<void()> &wait
+        )
+        {
+          if (dm != nullptr) dm->mpi_call(post, test, wait);
+          else
+          {
+            post();
+            wait();
+          }
+        }
+
+        // non-blocking counterpart of boost::mpi::wait_all (boost's test_all never succeeds for unused requests)
+        template <class it_t>
+        static bool test_all(it_t first, const it_t last)
+        {
+          bool done = true;
+          for (; first != last; ++first)
+            if (first->active() && !first->test()) done = false;
+          return done;
+        }
+
+        void shm_sync()
+        {
+          std::array<boost::mpi::request, 2> rs;
+          auto win_sync = [&]{ for (auto sh : shm_tmp) MPI_Win_sync(sh->win); };
+          mpi_call(
+            [&]{
+              win_sync();
+              rs[0] = mpicom.isend(peer, tag + (dir == left ? left : rght));
+              rs[1] = mpicom.irecv(peer, tag + (dir == left ? rght : left));
+            },
+            [&]{
+              if (!test_all(rs.begin(), rs.end())) return false;
+              win_sync();
+              return true;
+            },
+            [&]{
+              boost::mpi::wait_all(rs.begin(), rs.end());
+              win_sync();
+            }
+          );
+        }
+
+        // returns false if not all arrays are in shared memory (same on both sides, hence no mismatch)
+        template <class ptrs_t>
+        bool shm_xchng(
+          const ptrs_t &as,
+          const idx_t *idx_recv // null if only sending
+        )
+        {
+          if (shm_peer < 0) return false;
+
+          shm_tmp.clear();
+          for (const auto a : as)
+          {
+            auto it = dm->shm_arrs.find(a->dataFirst());
+            if (it == dm->shm_arrs.end()) return false;
+            shm_tmp.push_back(&it->second);
+          }
+
+          // waiting for the neighbour to finish writing its data
+          shm_sync();
+
+          if (idx_recv != nullptr)
+          {
+            blitz::TinyVector<int, n_dims> lbound = idx_recv->lbound(), ubound = idx_recv->ubound();
+            lbound[dim] += shm_shift;
+            ubound[dim] += shm_shift;
+            const idx_t idx_peer(lbound, ubound);
+
+            for (std::size_t i = 0; i < shm_tmp.size(); ++i)
+            {
+              const auto &geom = shm_tmp[i]->geoms[shm_peer];
+              blitz::TinyVector<int, n_dims> shape, base;
+              for (int d = 0; d < n_dims; ++d)
+              {
+                base[d] = geom[2 * d];
+                shape[d] = geom[2 * d + 1];
+              }
+              arr_t peer_arr(shm_tmp[i]->ptrs[shm_peer], shape, blitz::neverDeleteData);
+              peer_arr.reindexSelf(base);
+
+              (*as[i])(*idx_recv) = peer_arr(idx_peer);
+            }
+          }
+
+          // waiting for the neighbour to finish reading our data
+          shm_sync();
+          return true;
+        }
+
+        // persistent requests for halos described in place with subarray datatypes (no packing, enabled with rt_params_t::mpi_persistent),
+        // created once per array (data pointer and shape) and halo index
+        struct prst_t
+        {
+          MPI_Datatype type;
+          MPI_Request req;
+        };
+        using prst_key_t = std::tuple<const real_t*, std::array<int, 3 * n_dims>>;
+        std::map<prst_key_t, prst_t> prst_send, prst_recv;
+
+        // subarray datatypes require contiguous storage in C order
+        static bool prst_able(const arr_t &a)
+        {
+          if (!a.isStorageContiguous()) return false;
+          for (int r = 0; r < n_dims; ++r)
+            if (a.ordering(r) != n_dims - 1 - r || !a.isRankStoredAscending(r)) return false;
+          return true;
+        }
+
+        MPI_Request prst_req(const arr_t &a, const idx_t &idx, const bool send)
+        {
+          prst_key_t key;
+          std::get<0>(key) = a.dataFirst();
+          for (int d = 0; d < n_dims; ++d)
+          {
+            std::get<1>(key)[3 * d + 0] = a.extent(d);
+            std::get<1>(key)[3 * d + 1] = idx[d].first();
+            std::get<1>(key)[3 * d + 2] = idx[d].last();
+          }
+
+          auto &cache = send ? prst_send : prst_recv;
+          auto it = cache.find(key);
+          if (it == cache.end())
+          {
+            std::array<int, n_dims> sizes, subsizes, starts;
+            for (int d = 0; d < n_dims; ++d)
+            {
+              sizes[d] = a.extent(d);
+              subsizes[d] = idx[d].length();
+              starts[d] = idx[d].first() - a.lbound(d);
+            }
+
+            prst_t p;
+            MPI_Type_create_subarray(n_dims, sizes.data(), subsizes.data(), starts.data(),
+              MPI_ORDER_C, boost::mpi::get_mpi_datatype<real_t>(), &p.type
+            );
+            MPI_Type_commit(&p.type);
+
+            // the same tags as in send_hlpr() and recv_hlpr()
+            real_t *ptr = const_cast<real_t*>(a.dataFirst());
+            if (send)
+              MPI_Send_init(ptr, 1, p.type, peer, tag + (dir == left ? left : rght), mpicom, &p.req);
+            else
+              MPI_Recv_init(ptr, 1, p.type, peer, tag + (dir == left ? rght : left), mpicom, &p.req);
+
+            it = cache.emplace(key, p).first;
+          }
+          return it->second.req;
+        }
+
+        // zero-copy exchange (any of the indices may be null), returns false if the array is not supported
+        bool prst_xchng(
+          const arr_t &a,
+          const idx_t *idx_send,
+          const idx_t *idx_recv
+        )
+        {
+          if (dm == nullptr || !dm->persistent_xchng || !prst_able(a)) return false;
+
+          std::array<MPI_Request, 2> rs;
+          int n = 0;
+
+          mpi_call(
+            [&]{
+              if (idx_send != nullptr && a(*idx_send).size() != 0)
+              {
+                rs[n++] = prst_req(a, *idx_send, true);
+#  if !defined(NDEBUG)
+                reqs[1] = mpicom.isend(peer, (tag + (dir == left ? left : rght)) ^ debug, std::pair<int,int>(
+                  (*idx_send)[dim].first(),
+                  (*idx_send)[dim].last()
+                ));
+#  endif
+              }
+
+              if (idx_recv != nullptr && a(*idx_recv).size() != 0)
+              {
+                rs[n++] = prst_req(a, *idx_recv, false);
+#  if !defined(NDEBUG)
+                reqs[3] = mpicom.irecv(peer, (tag + (dir == left ? rght : left)) ^ debug, buf_rng);
+#  endif
+              }
+
+              // note: persistent requests stay allocated after completion, so copies of the handles can be used here
+              MPI_Startall(n, rs.data());
+            },
+            [&]{
+              int flag;
+              MPI_Testall(n, rs.data(), &flag, MPI_STATUSES_IGNORE);
+#  if !defined(NDEBUG)
+              if (!test_all(reqs.begin(), reqs.end())) return false;
+#  endif
+              return flag != 0;
+            },
+            [&]{
+              MPI_Waitall(n, rs.data(), MPI_STATUSES_IGNORE);
+#  if !defined(NDEBUG)
+              boost::mpi::wait_all(reqs.begin(), reqs.end());
+#  endif
+            }
+          );
+          return true;
+        }
 #endif
 
         protected:
-        const bool is_cyclic =
-#if defined(USE_MPI)
-          (dir == left && mpicom.rank() == 0) ||
-          (dir == rght && mpicom.rank() == mpicom.size()-1);
-#else
-          false;
-#endif
+        const bool is_cyclic; // if communicating across the domain edge
+
+        // shape and number of elements of a halo region
+        static blitz::TinyVector<int, n_dims> halo_shape(const idx_t &idx)
+        {
+          blitz::TinyVector<int, n_dims> shp;
+          for (int d = 0; d < n_dims; ++d) shp[d] = std::max(idx.ubound(d) - idx.lbound(d) + 1, 0);
+          return shp;
+        }
 
+        static std::size_t halo_size(const idx_t &idx)
+        {
+          std::size_t n = 1;
+          for (int d = 0; d < n_dims; ++d) n *= halo_shape(idx)[d];
+          return n;
+        }
+
+        // the halos of all arrays in as are packed one after another into a single message
+        template <class ptrs_t>
         void send_hlpr(
-          const arr_t &a,
+          const ptrs_t &as,
           const idx_t &idx_send
         )
         {
@@ -76,25 +314,30 @@ namespace libmpdataxx
           // distinguishing between left and right messages
           // (important e.g. with 2 procs and cyclic bc)
           const int
-            msg_send = dir == left ? left : rght;
+            msg_send = tag + (dir == left ? left : rght);
 
-          // arr_send references part of the send buffer that will be used
-          arr_t arr_send(buf_send, a(idx_send).shape(), blitz::neverDeleteData);
-          // copying data to be sent
-          arr_send = a(idx_send);
+          std::size_t cnt = 0;
+          for (const auto a : as)
+          {
+            // arr_send references part of the send buffer that will be used
+            arr_t arr_send(buf_send + cnt, halo_shape(idx_send), blitz::neverDeleteData);
+            // copying data to be sent
+            arr_send = (*a)(idx_send);
+            cnt += arr_send.size();
+          }
 
           // launching async data transfer
-          if(arr_send.size()!=0)
+          if(cnt!=0)
           {
             // use the pointer+size kind of send instead of serialization of blitz arrays, because
             // serialization caused memory leaks, probably because it breaks blitz reference counting
-            reqs[0] = mpicom.isend(peer, msg_send, buf_send, arr_send.size());
+            reqs[0] = mpicom.isend(peer, msg_send, buf_send, cnt);
 
             // sending debug information
 #  if !defined(NDEBUG)
             reqs[1] = mpicom.isend(peer, msg_send ^ debug, std::pair<int,int>(
-              idx_send[0].first(),
-              idx_send[0].last()
+              idx_send[dim].first(),
+              idx_send[dim].last()
             ));
 #  endif
           }
@@ -103,20 +346,22 @@ namespace libmpdataxx
 #endif
         };
 
+        template <class ptrs_t>
         void recv_hlpr(
-          const arr_t &a,
+          const ptrs_t &as,
           const idx_t &idx_recv
         )
         {
 #if defined(USE_MPI)
           const int
-            msg_recv = dir == left ? rght : left;
+            msg_recv = tag + (dir == left ? rght : left);
 
+          const std::size_t cnt = as.size() * halo_size(idx_recv);
 
           // launching async data transfer
-          if(a(idx_recv).size()!=0) // TODO: test directly size of idx_recv
+          if(cnt!=0)
           {
-            reqs[1+n_dbg_reqs] = mpicom.irecv(peer, msg_recv, buf_recv, a(idx_recv).size());
+            reqs[1+n_dbg_reqs] = mpicom.irecv(peer, msg_recv, buf_recv, cnt);
 
             // sending debug information
 #  if !defined(NDEBUG)
@@ -128,16 +373,64 @@ namespace libmpdataxx
 #endif
         }
 
+        // writing received data to the arrays (in the order they were packed)
+        template <class ptrs_t>
+        void unpack(
+          const ptrs_t &as,
+          const idx_t &idx_recv
+        )
+        {
+#if defined(USE_MPI)
+          if (halo_size(idx_recv) == 0) return;
+
+          // checking debug information: the halo sent by the neighbour has to be as wide as the one received
+          // (indices differ across the domain edge and with a different subdomain origin)
+#  if !defined(NDEBUG)
+          assert(buf_rng.second - buf_rng.first == idx_recv[dim].last() - idx_recv[dim].first());
+#  endif
+
+          std::size_t cnt = 0;
+          for (const auto a : as)
+          {
+            // a blitz handler for the used part of the receive buffer
+            arr_t arr_recv(buf_recv + cnt, halo_shape(idx_recv), blitz::neverDeleteData);
+
+            (*a)(idx_recv) = arr_recv;
+            cnt += arr_recv.size();
+          }
+#else
+          assert(false);
+#endif
+        }
+
+        // making sure the buffers can hold the halos of n arrays
+        void reserve(const std::size_t n)
+        {
+#if defined(USE_MPI)
+          if (n <= buf_n_arrs) return;
+          buf_send = (real_t *) realloc(buf_send, n * buf_size * sizeof(real_t));
+          buf_recv = (real_t *) realloc(buf_recv, n * buf_size * sizeof(real_t));
+          if (buf_send == nullptr || buf_recv == nullptr)
+            throw std::runtime_error("remote bcond: cannot allocate halo exchange buffers");
+          buf_n_arrs = n;
+#endif
+        }
+
         void send(
           const arr_t &a,
           const idx_t &idx_send
         )
         {
 #if defined(USE_MPI)
-          send_hlpr(a, idx_send);
-
-          // waiting for the transfers to finish
-          boost::mpi::wait_all(reqs.begin(), reqs.begin() + 1 + n_dbg_reqs); // MPI_Waitall is thread-safe?
+          if (shm_xchng(std::array<const arr_t*, 1>{{&a}}, nullptr)) return;
+          if (prst_xchng(a, &idx_send, nullptr)) return;
+
+          mpi_call(
+            [&]{ send_hlpr(std::array<const arr_t*, 1>{{&a}}, idx_send); },
+            [&]{ return test_all(reqs.begin(), reqs.begin() + 1 + n_dbg_reqs); },
+            // waiting for the transfers to finish
+            [&]{ boost::mpi::wait_all(reqs.begin(), reqs.begin() + 1 + n_dbg_reqs); } // MPI_Waitall is thread-safe?
+          );
 #else
           assert(false);
 #endif
@@ -149,24 +442,42 @@ namespace libmpdataxx
         )
         {
 #if defined(USE_MPI)
-          //auto arr_recv = recv_hlpr(a, idx_recv);
-          recv_hlpr(a, idx_recv);
-
-          // waiting for the transfers to finish
-          boost::mpi::wait_all(reqs.begin() + 1 + n_dbg_reqs, reqs.end()); // MPI_Waitall is thread-safe?
-
-          // a blitz handler for the used part of the receive buffer
-          arr_t arr_recv(buf_recv, a(idx_recv).shape(), blitz::neverDeleteData); // TODO: shape directly from idx_recv
-
-          // checking debug information
-
-          // positive modulo (grid_size_0 - 1)
-//          auto wrap = [this](int n) {return (n % (grid_size_0 - 1) + grid_size_0 - 1) % (grid_size_0 - 1);};
-//          assert(wrap(buf_rng.first) == wrap(idx_recv[0].first()));
-//          assert(wrap(buf_rng.second) == wrap(idx_recv[0].last()));
+          if (shm_xchng(std::array<const arr_t*, 1>{{&a}}, &idx_recv)) return;
+          if (prst_xchng(a, nullptr, &idx_recv)) return;
+
+          const std::array<const arr_t*, 1> as{{&a}};
+          mpi_call(
+            [&]{ recv_hlpr(as, idx_recv); },
+            [&]{ return test_all(reqs.begin() + 1 + n_dbg_reqs, reqs.end()); },
+            // waiting for the transfers to finish
+            [&]{ boost::mpi::wait_all(reqs.begin() + 1 + n_dbg_reqs, reqs.end()); } // MPI_Waitall is thread-safe?
+          );
+
+          unpack(as, idx_recv);
+#else
+          assert(false);
+#endif
+        }
 
-          // writing received data to the array
-          a(idx_recv) = arr_recv;
+        template <class ptrs_t>
+        void xchng_hlpr(
+          const ptrs_t &as,
+          const idx_t &idx_send,
+          const idx_t &idx_recv
+        )
+        {
+#if defined(USE_MPI)
+          mpi_call(
+            [&]{
+              send_hlpr(as, idx_send);
+              recv_hlpr(as, idx_recv);
+            },
+            [&]{ return test_all(reqs.begin(), reqs.end()); },
+            // waiting for the transfers to finish
+            [&]{ boost::mpi::wait_all(reqs.begin(), reqs.end()); }
+          );
+
+          unpack(as, idx_recv);
 #else
           assert(false);
 #endif
@@ -179,44 +490,59 @@ namespace libmpdataxx
         )
         {
 #if defined(USE_MPI)
-          send_hlpr(a, idx_send);
-          recv_hlpr(a, idx_recv);
-
-          // waiting for the transfers to finish
-          boost::mpi::wait_all(reqs.begin(), reqs.end());
-
-          // a blitz handler for the used part of the receive buffer
-          arr_t arr_recv(buf_recv, a(idx_recv).shape(), blitz::neverDeleteData);
-
-          // checking debug information
-
-          // positive modulo (grid_size_0 - 1)
-         // auto wrap = [this](int n) {return (n % (grid_size_0 - 1) + grid_size_0 - 1) % (grid_size_0 - 1);};
-         // assert(wrap(buf_rng.first) == wrap(idx_recv[0].first()));
-         // assert(wrap(buf_rng.second) == wrap(idx_recv[0].last()));
+          if (shm_xchng(std::array<const arr_t*, 1>{{&a}}, &idx_recv)) return;
+          if (prst_xchng(a, &idx_send, &idx_recv)) return;
+#endif
+          xchng_hlpr(std::array<const arr_t*, 1>{{&a}}, idx_send, idx_recv);
+        }
 
-          // writing received data to the array
-          a(idx_recv) = arr_recv;
-#else
-          assert(false);
+        // halos of all the arrays exchanged with a single pair of messages
+        void xchng(
+          const std::vector<arr_t*> &as,
+          const idx_t &idx_send,
+          const idx_t &idx_recv
+        )
+        {
+#if defined(USE_MPI)
+          if (shm_xchng(as, &idx_recv)) return;
 #endif
+          reserve(as.size());
+          xchng_hlpr(as, idx_send, idx_recv);
         }
 
         public:
 
         // ctor
+        // (chan distinguishes messages exchanged with the same peer, e.g. by different threads)
         remote_common(
           const rng_t &i,
-          const std::array<int, n_dims> &grid_size
+          const std::array<int, n_dims> &grid_size,
+          const int peer,
+          const bool is_cyclic,
+          const int chan = 0,
+          const concurr::detail::distmem<real_t, n_dims> *dm = nullptr
         ) :
           parent_t(i, grid_size),
-          grid_size_0(grid_size[0])
+#if defined(USE_MPI)
+          peer(peer),
+          tag(4 * (chan * n_dims + dim)), // left, rght and the debug messages (see send_hlpr)
+          dm(dm),
+          shm_peer(dm == nullptr ? -1 : dm->shm_rank(peer)),
+          // periodic domain with the first and last points coinciding
+          shm_shift(!is_cyclic ? 0 : dir == left ? grid_size[dim] - 1 : -(grid_size[dim] - 1)),
+#endif
+          is_cyclic(is_cyclic)
         {
 #if defined(USE_MPI)
-          const int slice_size = n_dims==1 ? 1 : (n_dims==2? grid_size[1]+6 : (grid_size[1]+6) * (grid_size[2]+6) ); // 3 is the max halo size (?), so 6 on both sides
+          // slice perpendicular to dim, 3 is the max halo size (?), so 6 on both sides
+          std::size_t slice_size = 1;
+          for (int d = 0; d < n_dims; ++d)
+            if (d != dim) slice_size *= grid_size[d] + 6;
           // allocate enough memory in buffers to store largest halos to be sent
-          buf_send = (real_t *) malloc(halo * slice_size * sizeof(real_t));
-          buf_recv = (real_t *) malloc(halo * slice_size * sizeof(real_t));
+          // (enlarged by reserve() if halos of several arrays are exchanged at once)
+          buf_size = halo * slice_size;
+          buf_send = (real_t *) malloc(buf_size * sizeof(real_t));
+          buf_recv = (real_t *) malloc(buf_size * sizeof(real_t));
 #endif
         }
 
@@ -226,6 +552,18 @@ namespace libmpdataxx
 #if defined(USE_MPI)
           free(buf_send);
           free(buf_recv);
+
+          int finalized;
+          MPI_Finalized(&finalized);
+          if (!finalized)
+          {
+            for (auto cache : {&prst_send, &prst_recv})
+              for (auto &p : *cache)
+              {
+                MPI_Request_free(&p.second.req);
+                MPI_Type_free(&p.second.type);
+              }
+          }
 #endif
         }
       };
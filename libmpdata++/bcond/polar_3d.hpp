@@ -29,46 +29,24 @@ namespace libmpdataxx
       // method invoked by the solver
       void fill_halos_sclr(arr_t &a, const rng_t &j, const rng_t &k, const bool deriv = false)
       {
-        using namespace idxperm;
-        for (int i = 0; i < halo; ++i)
-        {
-          for (int jj = j.first(); jj <= j.last(); jj++)
-          {
-            a(pi<d>(this->left_halo_sclr.last() - i, jj, k))
-            =
-            a(pi<d>(this->left_edge_sclr + i, this->polar_neighbours(jj), k));
-
-          }
-        }
+        typename parent_t::rows_t rows;
+        for (int i = 0; i < halo; ++i) rows.emplace_back(this->left_halo_sclr.last() - i, this->left_edge_sclr + i);
+        this->template polar_copy<d>(a, rows, j, k);
       }
 
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const rng_t &k, const bool ad = false)
       {
         using namespace idxperm;
         if (!ad) av[d](pi<d>(this->left_halo_vctr.last(), j, k)) = 0;
-        if (halo > 1)
-        {
-          for (int jj = j.first(); jj <= j.last(); jj++)
-          {
-            av[d](pi<d>(this->left_halo_vctr.first(), jj, k))
-            =
-            av[d](pi<d>(this->left_edge_sclr + h, this->polar_neighbours(jj), k));
-          }
-        }
+        if (halo > 1) this->template polar_copy<d>(av[d], {{this->left_halo_vctr.first(), this->left_edge_sclr + h}}, j, k);
       }
 
       void fill_halos_vctr_nrml(arr_t &a, const rng_t &j, const rng_t &k)
       {
-        using namespace idxperm;
-        for (int i = 0; i < halo; ++i)
-        {
-          for (int jj = j.first(); jj <= j.last(); jj++)
-          {
-            a(pi<d>(this->left_halo_sclr.first() + i, jj + h, k))
-            =
-            a(pi<d>(this->left_intr_vctr.last() - i, this->polar_neighbours(jj) + h, k));
-          }
-        }
+        // (jj + h and its polar neighbour + h map to the same integer indices)
+        typename parent_t::rows_t rows;
+        for (int i = 0; i < halo; ++i) rows.emplace_back(this->left_halo_sclr.first() + i, this->left_intr_vctr.last() - i);
+        this->template polar_copy<d>(a, rows, j, k);
       }
     };
 
@@ -90,46 +68,24 @@ namespace libmpdataxx
       // method invoked by the solver
       void fill_halos_sclr(arr_t &a, const rng_t &j, const rng_t &k, const bool deriv = false)
       {
-        using namespace idxperm;
-
-        for (int i = 0; i < halo; ++i)
-        {
-          for (int jj = j.first(); jj <= j.last(); jj++)
-          {
-            a(pi<d>(this->rght_halo_sclr.first() + i, jj, k))
-            =
-            a(pi<d>(this->rght_edge_sclr - i, this->polar_neighbours(jj), k));
-          }
-        }
+        typename parent_t::rows_t rows;
+        for (int i = 0; i < halo; ++i) rows.emplace_back(this->rght_halo_sclr.first() + i, this->rght_edge_sclr - i);
+        this->template polar_copy<d>(a, rows, j, k);
       }
 
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const rng_t &k, const bool ad = false)
       {
         using namespace idxperm;
         if (!ad) av[d](pi<d>(this->rght_halo_vctr.first(), j, k)) = 0;
-        if (halo > 1)
-        {
-          for (int jj = j.first(); jj <= j.last(); jj++)
-          {
-            av[d](pi<d>(this->rght_halo_vctr.last(), jj, k))
-            =
-            av[d](pi<d>(this->rght_edge_sclr - h, this->polar_neighbours(jj), k));
-          }
-        }
+        if (halo > 1) this->template polar_copy<d>(av[d], {{this->rght_halo_vctr.last(), this->rght_edge_sclr - h}}, j, k);
       }
 
-      void fill_halos_vctr_nrml(arr_t &a, const rng_t &j,  const rng_t &k)
+      void fill_halos_vctr_nrml(arr_t &a, const rng_t &j, const rng_t &k)
       {
-        using namespace idxperm;
-        for (int i = 0; i < halo; ++i)
-        {
-          for (int jj = j.first(); jj <= j.last(); jj++)
-          {
-            a(pi<d>(this->rght_halo_sclr.first() + i, jj + h, k))
-            =
-            a(pi<d>(this->rght_intr_vctr.last() - i, this->polar_neighbours(jj) + h, k));
-          }
-        }
+        // (jj + h and its polar neighbour + h map to the same integer indices)
+        typename parent_t::rows_t rows;
+        for (int i = 0; i < halo; ++i) rows.emplace_back(this->rght_halo_sclr.first() + i, this->rght_intr_vctr.last() - i);
+        this->template polar_copy<d>(a, rows, j, k);
       }
     };
   } // namespace bcond
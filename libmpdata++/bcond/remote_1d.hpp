@@ -18,9 +18,9 @@ namespace libmpdataxx
         dir == left   &&
         n_dims == 1
       >::type
-    > : public detail::remote_common<real_t, halo, dir, n_dims>
+    > : public detail::remote_common<real_t, halo, dir, n_dims, dim>
     {
-      using parent_t = detail::remote_common<real_t, halo, dir, n_dims>;
+      using parent_t = detail::remote_common<real_t, halo, dir, n_dims, dim>;
       using arr_t = typename parent_t::arr_t;
       using idx_t = typename parent_t::idx_t;
       using idx_ctor_arg_t = blitz::TinyVector<rng_t, n_dims>;
@@ -35,6 +35,11 @@ namespace libmpdataxx
         this->xchng(a, idx_t(idx_ctor_arg_t(this->left_intr_sclr + off)), idx_t(idx_ctor_arg_t(this->left_halo_sclr)));
       }
 
+      void fill_halos_sclr_batch(const std::vector<arr_t*> &av, const bool deriv = false)
+      {
+        this->xchng(av, idx_t(idx_ctor_arg_t(this->left_intr_sclr + off)), idx_t(idx_ctor_arg_t(this->left_halo_sclr)));
+      }
+
       void fill_halos_pres(arr_t &a)
       {
         fill_halos_sclr(a);
@@ -111,9 +116,9 @@ namespace libmpdataxx
         dir == rght   &&
         n_dims == 1
       >::type
-    > : public detail::remote_common<real_t, halo, dir, n_dims>
+    > : public detail::remote_common<real_t, halo, dir, n_dims, dim>
     {
-      using parent_t = detail::remote_common<real_t, halo, dir, n_dims>;
+      using parent_t = detail::remote_common<real_t, halo, dir, n_dims, dim>;
       using arr_t = typename parent_t::arr_t;
       using idx_t = typename parent_t::idx_t;
       using idx_ctor_arg_t = blitz::TinyVector<rng_t, n_dims>;
@@ -128,6 +133,11 @@ namespace libmpdataxx
         this->xchng(a, idx_t(idx_ctor_arg_t(this->rght_intr_sclr + off)), idx_t(idx_ctor_arg_t(this->rght_halo_sclr)));
       }
 
+      void fill_halos_sclr_batch(const std::vector<arr_t*> &av, const bool deriv = false)
+      {
+        this->xchng(av, idx_t(idx_ctor_arg_t(this->rght_intr_sclr + off)), idx_t(idx_ctor_arg_t(this->rght_halo_sclr)));
+      }
+
       void fill_halos_pres(arr_t &a)
       {
         fill_halos_sclr(a);
@@ -18,9 +18,9 @@ namespace libmpdataxx
         dir == left   &&
         n_dims == 2
       >::type
-    > : public detail::remote_common<real_t, halo, dir, n_dims>
+    > : public detail::remote_common<real_t, halo, dir, n_dims, d>
     {
-      using parent_t = detail::remote_common<real_t, halo, dir, n_dims>;
+      using parent_t = detail::remote_common<real_t, halo, dir, n_dims, d>;
       using arr_t = blitz::Array<real_t, 2>;
       using parent_t::parent_t; // inheriting ctor
 
@@ -34,6 +34,12 @@ namespace libmpdataxx
         this->xchng(a, pi<d>(this->left_intr_sclr + off, j), pi<d>(this->left_halo_sclr, j));
       }
 
+      void fill_halos_sclr_batch(const std::vector<arr_t*> &av, const rng_t &j, const bool deriv = false)
+      {
+        using namespace idxperm;
+        this->xchng(av, pi<d>(this->left_intr_sclr + off, j), pi<d>(this->left_halo_sclr, j));
+      }
+
       void fill_halos_pres(arr_t &a, const rng_t &j)
       {
         fill_halos_sclr(a, j);
@@ -114,9 +120,9 @@ namespace libmpdataxx
         dir == rght   &&
         n_dims == 2
       >::type
-    > : public detail::remote_common<real_t, halo, dir, n_dims>
+    > : public detail::remote_common<real_t, halo, dir, n_dims, d>
     {
-      using parent_t = detail::remote_common<real_t, halo, dir, n_dims>;
+      using parent_t = detail::remote_common<real_t, halo, dir, n_dims, d>;
       using arr_t = blitz::Array<real_t, 2>;
       using parent_t::parent_t; // inheriting ctor
 
@@ -130,6 +136,12 @@ namespace libmpdataxx
         this->xchng(a, pi<d>(this->rght_intr_sclr + off, j), pi<d>(this->rght_halo_sclr, j));
       }
 
+      void fill_halos_sclr_batch(const std::vector<arr_t*> &av, const rng_t &j, const bool deriv = false)
+      {
+        using namespace idxperm;
+        this->xchng(av, pi<d>(this->rght_intr_sclr + off, j), pi<d>(this->rght_halo_sclr, j));
+      }
+
       void fill_halos_pres(arr_t &a, const rng_t &j)
       {
         fill_halos_sclr(a, j);
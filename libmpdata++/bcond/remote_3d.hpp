@@ -18,10 +18,10 @@ namespace libmpdataxx
         dir == left   &&
         n_dims == 3
       >::type
-    > : public detail::remote_common<real_t, halo, dir, n_dims>
+    > : public detail::remote_common<real_t, halo, dir, n_dims, d>
     {
 
-      using parent_t = detail::remote_common<real_t, halo, dir, n_dims>;
+      using parent_t = detail::remote_common<real_t, halo, dir, n_dims, d>;
       using arr_t = blitz::Array<real_t, 3>;
       using parent_t::parent_t; // inheriting ctor
 
@@ -35,6 +35,12 @@ namespace libmpdataxx
         this->xchng(a, pi<d>(this->left_intr_sclr + off, j, k), pi<d>(this->left_halo_sclr, j, k));
       }
 
+      void fill_halos_sclr_batch(const std::vector<arr_t*> &av, const rng_t &j, const rng_t &k, const bool deriv = false)
+      {
+        using namespace idxperm;
+        this->xchng(av, pi<d>(this->left_intr_sclr + off, j, k), pi<d>(this->left_halo_sclr, j, k));
+      }
+
       void fill_halos_pres(arr_t &a, const rng_t &j, const rng_t &k)
       {
         fill_halos_sclr(a, j, k);
@@ -111,9 +117,9 @@ namespace libmpdataxx
         dir == rght   &&
         n_dims == 3
       >::type
-    > : public detail::remote_common<real_t, halo, dir, n_dims>
+    > : public detail::remote_common<real_t, halo, dir, n_dims, d>
     {
-      using parent_t = detail::remote_common<real_t, halo, dir, n_dims>;
+      using parent_t = detail::remote_common<real_t, halo, dir, n_dims, d>;
       using arr_t = blitz::Array<real_t, 3>;
       using parent_t::parent_t; // inheriting ctor
 
@@ -127,6 +133,12 @@ namespace libmpdataxx
         this->xchng(a, pi<d>(this->rght_intr_sclr + off, j, k), pi<d>(this->rght_halo_sclr, j, k));
       }
 
+      void fill_halos_sclr_batch(const std::vector<arr_t*> &av, const rng_t &j, const rng_t &k, const bool deriv = false)
+      {
+        using namespace idxperm;
+        this->xchng(av, pi<d>(this->rght_intr_sclr + off, j, k), pi<d>(this->rght_halo_sclr, j, k));
+      }
+
       void fill_halos_pres(arr_t &a, const rng_t &j, const rng_t &k)
       {
         fill_halos_sclr(a, j, k);
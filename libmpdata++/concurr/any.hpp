@@ -7,6 +7,15 @@
 #pragma once
 
 #include <libmpdata++/blitz.hpp>
+#include <libmpdata++/concurr/detail/barrier_stats.hpp>
+#include <libmpdata++/concurr/detail/hw_counters.hpp>
+#include <libmpdata++/concurr/detail/mem_stats.hpp>
+#include <libmpdata++/concurr/detail/phase_timers.hpp>
+
+#include <map>
+#include <string>
+#include <functional>
+#include <vector>
 
 namespace libmpdataxx
 {
@@ -27,10 +36,22 @@ namespace libmpdataxx
       const blitz::Array<real_t, n_dims> advectee_global(int eqn = 0)
       { assert(false); throw; }
 
+      // the global advectee gathered on rank 0 only (an empty array on other ranks)
+      virtual
+      blitz::Array<real_t, n_dims> advectee_root(int eqn = 0)
+      { assert(false); throw; }
+
+      // with MPI, only the array passed on rank 0 is used
       virtual
       void advectee_global_set(const blitz::Array<real_t, n_dims>, int eqn = 0)
       { assert(false); throw; }
 
+      // init is called with the part of the advectee owned by the calling rank
+      // (indexed as the global array), no global array is needed
+      virtual
+      void advectee_local_set(const std::function<void(blitz::Array<real_t, n_dims>)> &init, int eqn = 0)
+      { assert(false); throw; }
+
       virtual
       blitz::Array<real_t, n_dims> advector(int dim = 0)
       { assert(false); throw; }
@@ -51,6 +72,16 @@ namespace libmpdataxx
       blitz::Array<real_t, n_dims> sclr_array(const std::string &name, int n = 0)
       { assert(false); throw; }
 
+      // saving the complete solver state to a file
+      virtual
+      void checkpoint(const std::string &path)
+      { assert(false); throw; }
+
+      // restoring the solver state from a file written by checkpoint()
+      virtual
+      void restart(const std::string &path)
+      { assert(false); throw; }
+
       virtual
       bool *panic_ptr()
       { assert(false && "unimplemented!"); throw; }
@@ -69,6 +100,30 @@ namespace libmpdataxx
       const real_t max(int eqn = 0) const
       { assert(false); throw; }
 
+      // time spent in the timed regions of the solver (by path, e.g. "solve_loop_body/advop"),
+      // over all threads and processes, mpi-aware; empty unless ct_params_t::phase_timers is set
+      virtual
+      std::map<std::string, detail::phase_stats_t> phase_timings()
+      { assert(false); throw; }
+
+      // waiting at each call site of barrier(), mpi-aware, sorted from the longest average
+      // waiting time; empty unless rt_params_t::barrier_profile is set
+      virtual
+      std::vector<detail::barrier_stats_t> barrier_profile()
+      { assert(false); throw; }
+
+      // cycles, instructions and last-level cache misses of the timed regions (see phase_timings) in each
+      // thread of each process, mpi-aware, NaN if not available; empty unless rt_params_t::hw_counters is set
+      virtual
+      std::vector<detail::hw_stats_t> hw_counts()
+      { assert(false); throw; }
+
+      // memory used by the arrays of the solver (see rt_params_t::memory_report), by the file
+      // owning them and their purpose, mpi-aware, sorted from the largest
+      virtual
+      std::vector<detail::mem_stats_t> memory_usage()
+      { assert(false); throw; }
+
       // dtor
       virtual ~any() {}
     };
@@ -0,0 +1,31 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief summary of waiting at barriers per call site, see concurr::any::barrier_profile()
+ */
+
+#pragma once
+
+#include <string>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // waiting at a call site of sharedmem_common::barrier(), over all threads of all processes
+      struct barrier_stats_t
+      {
+        std::string site;                        // file:line
+        double calls_per_step = 0;               // per thread
+        double wait_min = 0, wait_avg = 0, wait_max = 0; // total time spent waiting by a thread
+        double max_wait = 0;                     // the longest single wait
+        int latest_thread = 0;                   // the thread waiting least in total (summed over processes),
+                                                 // i.e. usually the last one to arrive
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
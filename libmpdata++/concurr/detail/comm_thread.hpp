@@ -0,0 +1,121 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief a dedicated thread doing all MPI communication on behalf of the solver threads
+ *   (allows running with MPI_THREAD_SERIALIZED instead of MPI_THREAD_MULTIPLE)
+ */
+
+#pragma once
+
+#include <boost/lockfree/queue.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      class comm_thread
+      {
+        // post() starts the communication (e.g. isend/irecv), test() is then called
+        // repeatedly until it returns true (e.g. after a successful MPI_Test)
+        struct task_t
+        {
+          const std::function<void()> &post;
+          const std::function<bool()> &test;
+          std::atomic<bool> done;
+
+          task_t(const std::function<void()> &post, const std::function<bool()> &test) :
+            post(post), test(test), done(false)
+          {}
+        };
+
+        boost::lockfree::queue<task_t*> queue;
+        std::atomic<bool> stop;
+
+        // the thread sleeps when there is nothing to be done (no task queued or pending)
+        std::mutex mtx;
+        std::condition_variable wake;
+
+        std::thread thread; // started last, once the members above are initialised
+
+        // pushing and then locking the mutex ensures the thread either sees the task when checking
+        // the queue or is already waiting when notified
+        void notify()
+        {
+          {
+            std::lock_guard<std::mutex> lock(mtx);
+          }
+          wake.notify_one();
+        }
+
+        void loop()
+        {
+          std::vector<task_t*> active;
+          while (!stop.load(std::memory_order_acquire) || !active.empty())
+          {
+            task_t *task;
+            while (queue.pop(task))
+            {
+              task->post();
+              active.push_back(task);
+            }
+
+            // progressing all the pending transfers, so that they overlap
+            for (auto it = active.begin(); it != active.end();)
+            {
+              if ((*it)->test())
+              {
+                (*it)->done.store(true, std::memory_order_release);
+                it = active.erase(it);
+              }
+              else ++it;
+            }
+
+            // spinning only while transfers are pending
+            if (active.empty())
+            {
+              std::unique_lock<std::mutex> lock(mtx);
+              wake.wait(lock, [this]{ return !queue.empty() || stop.load(std::memory_order_acquire); });
+            }
+          }
+        }
+
+        public:
+
+        // called by the solver threads, returns once test() returned true
+        void run(const std::function<void()> &post, const std::function<bool()> &test)
+        {
+          task_t task(post, test);
+          while (!queue.push(&task));
+          notify();
+          while (!task.done.load(std::memory_order_acquire)) std::this_thread::yield();
+        }
+
+        // ctor
+        comm_thread() :
+          queue(64),
+          stop(false),
+          thread(&comm_thread::loop, this)
+        {}
+
+        // dtor
+        ~comm_thread()
+        {
+          stop.store(true, std::memory_order_release);
+          notify();
+          thread.join();
+        }
+      };
+    }
+  }
+}
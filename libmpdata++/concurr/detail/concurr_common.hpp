@@ -11,11 +11,28 @@
 #  error _REENTRANT not defined, please use something like -pthread flag for gcc
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <libmpdata++/blitz.hpp>
 
 #include <libmpdata++/concurr/detail/sharedmem.hpp>
 #include <libmpdata++/concurr/detail/timer.hpp>
+#include <libmpdata++/concurr/detail/barrier_stats.hpp>
+#include <libmpdata++/concurr/detail/hw_counters.hpp>
+#include <libmpdata++/concurr/detail/mem_stats.hpp>
+#include <libmpdata++/concurr/detail/phase_timers.hpp>
 #include <libmpdata++/concurr/any.hpp>
 
 #include <libmpdata++/bcond/shared.hpp>
@@ -82,6 +99,12 @@ namespace libmpdataxx
         std::unique_ptr<mem_t> mem;
         timer tmr;
 
+        // thread subdomains in the first dimension, resized between advance() calls if slab_rebalance is set
+        const bool slab_rebalance;
+        std::vector<rng_t> slabs;
+
+        const bool memory_report, hw_report;
+
         public:
 
         typedef typename solver_t::real_t real_t;
@@ -91,6 +114,11 @@ namespace libmpdataxx
         virtual ~concurr_common()
         {
           tmr.print();
+          // collective with MPI, hence skipped if an error occurred
+          if (solver_t::ct_params_t_::phase_timers && !std::uncaught_exception()) print_phase_timings();
+          if (mem->barrier_profiling && !std::uncaught_exception()) print_barrier_profile();
+          if (memory_report && !std::uncaught_exception()) print_peak_memory();
+          if (hw_report && !std::uncaught_exception()) print_hw_counts();
         }
 
         // ctor
@@ -98,51 +126,171 @@ namespace libmpdataxx
           const typename solver_t::rt_params_t &p,
           mem_t *mem_p,
           const int &size
-        ) {
+        ) :
+          slab_rebalance(p.slab_rebalance),
+          memory_report(p.memory_report),
+          hw_report(p.hw_counters)
+        {
           // allocate the memory to be shared by multiple threads
           mem.reset(mem_p);
+
+          // halos exchanged with neighbouring processes come from their interior
+          for (int d = 0; d < solver_t::n_dims; ++d)
+            if (mem->distmem.dims[d] > 1 && mem->grid_size[d].length() < solver_t::halo)
+              throw std::runtime_error("subdomain of a process narrower than the halo (reduce the number of processes)");
+
           solver_t::alloc(mem.get(), p.n_iters);
 
+          // the antipodes exchanged across processes are computed from the initial thread ranges (see bc_alloc)
+          if (
+            slab_rebalance && mem->distmem.size() > 1 &&
+            (bcxl == bcond::polar || bcxr == bcond::polar || bcyl == bcond::polar || bcyr == bcond::polar)
+          ) throw std::runtime_error("slab_rebalance does not work with polar boundary conditions with MPI");
+
+          mem->barrier_profiling = p.barrier_profile;
+#if defined(USE_MPI)
+          mem->distmem.persistent_xchng = p.mpi_persistent;
+#endif
+          if (!p.trace_path.empty())
+          {
+            if (!solver_t::ct_params_t_::tracing)
+              throw std::runtime_error("trace_path requires ct_params_t::tracing");
+            mem->trace.reset(new tracer(p.trace_path, size, mem->distmem.rank(), mem->distmem.size()));
+#if defined(USE_MPI)
+            mem->distmem.trace = mem->trace.get();
+#endif
+          }
+
           // allocate per-thread structures
           init(p, mem->grid_size, size);
+
+          for (int i0 = 0; i0 < size; ++i0)
+            slabs.push_back(mem->slab(mem->grid_size[0], i0, size));
+
+          // after init() since the output allocates its buffers there
+          if (memory_report) print_memory_usage();
         }
 
         private:
 
+        // bc allocation
         template <
           bcond::bcond_e type,
           bcond::drctn_e dir,
           int dim
         >
-        void bc_set(
-          typename solver_t::bcp_t &bcp
+        void bc_alloc(
+          typename solver_t::bcp_t &bcp,
+          const int,
+          std::integral_constant<int, 0> // non-remote
+        )
+        {
+          bcp.reset(
+            new bcond::bcond<real_t, solver_t::halo, type, dir, solver_t::n_dims, dim>(
+              mem->slab(mem->grid_size[dim]),
+              mem->distmem.grid_size
+            )
+          );
+        }
+
+        // remote bc allocation, all mpi routines called by the remote bcnd ctor are thread-safe (?)
+        template <
+          bcond::bcond_e type,
+          bcond::drctn_e dir,
+          int dim
+        >
+        void bc_alloc(
+          typename solver_t::bcp_t &bcp,
+          const int thread,
+          std::integral_constant<int, 1> // remote
         )
         {
-          // sanity check - polar coords do not work with MPI yet
-          if (type == bcond::polar && mem->distmem.size() > 1)
-            throw std::runtime_error("Polar boundary conditions do not work with MPI.");
+          auto &dm = mem->distmem;
+          bcp.reset(
+            new bcond::bcond<real_t, solver_t::halo, bcond::remote, dir, solver_t::n_dims, dim>(
+              mem->slab(mem->grid_size[dim]),
+              dm.grid_size,
+              dm.peer(dim, dir == bcond::left ? -1 : 1),
+              // communication across the domain edge
+              dir == bcond::left ? dm.coords[dim] == 0 : dm.coords[dim] == dm.dims[dim] - 1,
+              // in the first dimension halos are exchanged by one thread per process, in the other ones
+              // each thread exchanges its part with its counterpart (same thread count in all processes assumed)
+              dim == 0 ? 0 : thread,
+              &dm
+            )
+          );
+        }
 
-          // distmem overrides
-          if (type != bcond::remote && mem->distmem.size() > 1 && dim == 0)
+        // polar bc allocation, if the dimension in which the antipodes are sought (see polar_common)
+        // is divided among processes, the halos are filled with data from the processes sharing the pole;
+        // with MPI, polar boundary conditions are supported in 2D only
+        template <
+          bcond::bcond_e type,
+          bcond::drctn_e dir,
+          int dim
+        >
+        void bc_alloc(
+          typename solver_t::bcp_t &bcp,
+          const int thread,
+          std::integral_constant<int, 2> // polar
+        )
+        {
+          auto *bc = new bcond::bcond<real_t, solver_t::halo, bcond::polar, dir, solver_t::n_dims, dim>(
+            mem->slab(mem->grid_size[dim]),
+            mem->distmem.grid_size
+          );
+          bcp.reset(bc);
+
+#if defined(USE_MPI)
+          auto &dm = mem->distmem;
+          if (solver_t::n_dims != 2 && dm.size() > 1)
+            throw std::runtime_error("Polar boundary conditions with MPI are supported in 2D only.");
+          const int a = (dim + 1) % solver_t::n_dims;
+          if (dm.dims[a] == 1) return;
+
+          std::vector<int> ranks;
+          std::vector<rng_t> proc_rngs, thrd_rngs;
+          int self = 0;
+          for (int r = 0; r < dm.size(); ++r)
+          {
+            const auto coords = dm.coords_of(r);
+            if (coords[dim] != dm.coords[dim]) continue;
+            if (r == dm.rank()) self = ranks.size();
+            ranks.push_back(r);
+            const rng_t box = mem->distmem_box(coords)[a];
+            proc_rngs.push_back(box);
+            // threads divide the first dimension (same thread count in all processes assumed)
+            thrd_rngs.push_back(a == 0 ? mem->slab(box, thread, mem->size) : box);
+          }
+          bc->set_antipodes(&dm, ranks, self, proc_rngs, thrd_rngs, dim == 0 ? 0 : thread, dir == bcond::left);
+#endif
+        }
+
+        template <
+          bcond::bcond_e type,
+          bcond::drctn_e dir,
+          int dim
+        >
+        void bc_set(
+          typename solver_t::bcp_t &bcp,
+          const int thread = 0
+        )
+        {
+          // distmem overrides (in dimensions divided among processes)
+          if (type != bcond::remote && mem->distmem.dims[dim] > 1)
           {
             if (
               // distmem domain interior
-              (dir == bcond::left && mem->distmem.rank() > 0)
+              (dir == bcond::left && mem->distmem.coords[dim] > 0)
               ||
-              (dir == bcond::rght && mem->distmem.rank() != mem->distmem.size() - 1)
+              (dir == bcond::rght && mem->distmem.coords[dim] != mem->distmem.dims[dim] - 1)
               // cyclic condition for distmem domain (note: will not work if a non-cyclic condition is on the other end)
               ||
               (type == bcond::cyclic)
-            ) return bc_set<bcond::remote, dir, dim>(bcp);
+            ) return bc_set<bcond::remote, dir, dim>(bcp, thread);
           }
 
-          // bc allocation, all mpi routines called by the remote bcnd ctor are thread-safe (?)
-          bcp.reset(
-            new bcond::bcond<real_t, solver_t::halo, type, dir, solver_t::n_dims, dim>(
-              mem->slab(mem->grid_size[dim]),
-              mem->distmem.grid_size
-            )
-          );
+          bc_alloc<type, dir, dim>(bcp, thread, std::integral_constant<int, type == bcond::remote ? 1 : type == bcond::polar ? 2 : 0>());
         }
 
         // 1D version
@@ -192,8 +340,8 @@ namespace libmpdataxx
               bc_set<bcxl, bcond::left, 0>(bxl);
               bc_set<bcxr, bcond::rght, 0>(bxr);
 
-              bc_set<bcyl, bcond::left, 1>(byl);
-              bc_set<bcyr, bcond::rght, 1>(byr);
+              bc_set<bcyl, bcond::left, 1>(byl, i0);
+              bc_set<bcyr, bcond::rght, 1>(byr, i0);
 
               shrdl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>()); // TODO: shrdy if n1 != 1
               shrdr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>()); // TODO: shrdy if n1 != 1
@@ -234,11 +382,11 @@ namespace libmpdataxx
                 bc_set<bcxl, bcond::left, 0>(bxl);
                 bc_set<bcxr, bcond::rght, 0>(bxr);
 
-                bc_set<bcyl, bcond::left, 1>(byl);
-                bc_set<bcyr, bcond::rght, 1>(byr);
+                bc_set<bcyl, bcond::left, 1>(byl, i0);
+                bc_set<bcyr, bcond::rght, 1>(byr, i0);
 
-                bc_set<bczl, bcond::left, 2>(bzl);
-                bc_set<bczr, bcond::rght, 2>(bzr);
+                bc_set<bczl, bcond::left, 2>(bzl, i0);
+                bc_set<bczr, bcond::rght, 2>(bzr, i0);
 
                 shrdl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>()); // TODO: shrdy if n1 != 1
                 shrdr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>()); // TODO: shrdy if n1 != 1
@@ -266,13 +414,379 @@ namespace libmpdataxx
 
         virtual void solve(advance_arg_t nt) = 0;
 
+        // moves the boundaries between thread subdomains so that the time spent by each thread
+        // outside barriers (busy) becomes equal, assuming the cost of a grid column is uniform within
+        // a subdomain; the busy times are summed across processes so that the processes exchanging
+        // halos thread by thread (in the dimensions other than the first one) get identical subdomains
+        void rebalance(const double wall)
+        {
+          const int size = slabs.size();
+          std::vector<double> busy(size);
+          for (int t = 0; t < size; ++t)
+            busy[t] = std::max(wall - mem->barrier_wait[t], 0.);
+          mem->distmem.sum(busy);
+
+          const rng_t &all = mem->grid_size[0];
+          std::vector<double> cost(all.length());
+          for (int t = 0; t < size; ++t)
+            for (int c = slabs[t].first(); c <= slabs[t].last(); ++c)
+              cost[c - all.first()] = busy[t] / slabs[t].length();
+          const double total = std::accumulate(cost.begin(), cost.end(), 0.);
+          if (!(total > 0)) return;
+
+          // cutting the cumulative cost into equal parts, each subdomain at least halo wide
+          const int min_len = std::max(1, int(solver_t::halo));
+          if (min_len * size > all.length()) return;
+          std::vector<rng_t> res;
+          std::vector<double> busy_new;
+          double cum = 0;
+          for (int t = 0, first = all.first(); t < size; ++t)
+          {
+            int last = t == size - 1 ? all.last() : first + min_len - 1;
+            double part = 0;
+            for (int c = first; c <= last; ++c) part += cost[c - all.first()];
+            if (t < size - 1)
+            {
+              const double target = total * (t + 1) / size;
+              while (
+                last + 1 <= all.last() - min_len * (size - 1 - t) &&
+                cum + part + cost[last + 1 - all.first()] / 2 < target
+              ) part += cost[++last - all.first()];
+            }
+            res.push_back(rng_t(first, last));
+            busy_new.push_back(part);
+            cum += part;
+            first = last + 1;
+          }
+
+          auto imbalance = [](const std::vector<double> &v) {
+            return *std::max_element(v.begin(), v.end()) / (std::accumulate(v.begin(), v.end(), 0.) / v.size());
+          };
+          if (mem->distmem.rank() == 0)
+            std::cerr << "slab rebalancing: thread imbalance (max/avg busy time) measured " << imbalance(busy)
+                      << ", expected after resizing " << imbalance(busy_new) << std::endl;
+
+          for (int t = 0; t < size; ++t)
+          {
+            if (res[t].first() == slabs[t].first() && res[t].last() == slabs[t].last()) continue;
+            algos[t].set_slab(res[t]);
+            slabs[t] = res[t];
+          }
+        }
+
+        void print_phase_timings()
+        {
+          const auto stats = phase_timings();
+          if (mem->distmem.rank() != 0) return;
+
+          std::ostringstream tmp;
+          tmp << " phase timings (min/avg/max time [s] over threads and processes, number of calls):" << std::endl;
+          for (const auto &s : stats)
+          {
+            const auto depth = std::count(s.first.begin(), s.first.end(), '/');
+            const auto name = s.first.substr(s.first.rfind('/') + 1);
+            tmp << std::string(2 * depth + 2, ' ') << name << ": "
+                << s.second.min << " / " << s.second.avg << " / " << s.second.max
+                << " (" << s.second.count << ")" << std::endl;
+          }
+          std::cerr << tmp.str();
+        }
+
+        void print_barrier_profile(const int n_sites = 10)
+        {
+          const auto stats = barrier_profile();
+          if (mem->distmem.rank() != 0) return;
+
+          double per_step = 0;
+          for (const auto &s : stats) per_step += s.calls_per_step;
+
+          std::ostringstream tmp;
+          tmp << " barrier profile: " << per_step << " barriers per timestep, sites with the longest waiting"
+              << " (calls per timestep, min/avg/max total waiting time [s] of a thread, longest wait [s], last arriving thread):" << std::endl;
+          for (int i = 0; i < std::min(n_sites, int(stats.size())); ++i)
+          {
+            const auto &s = stats[i];
+            tmp << "  " << s.site << ": " << s.calls_per_step << ", "
+                << s.wait_min << " / " << s.wait_avg << " / " << s.wait_max << ", "
+                << s.max_wait << ", " << s.latest_thread << std::endl;
+          }
+          std::cerr << tmp.str();
+        }
+
+        void print_memory_usage()
+        {
+          const auto stats = memory_usage();
+          if (mem->distmem.rank() != 0) return;
+
+          double total = 0, total_max = 0;
+          for (const auto &s : stats)
+          {
+            total += s.bytes;
+            total_max += s.bytes_max;
+          }
+
+          std::ostringstream tmp;
+          tmp << " memory usage: " << total / (1 << 20) << " MiB in total, " << total_max / (1 << 20)
+              << " MiB at most in a process; by file and purpose (MiB in total, MiB at most in a process, arrays in a process):" << std::endl;
+          for (const auto &s : stats)
+            tmp << "  " << s.file.substr(s.file.rfind('/') + 1) << " " << s.purpose << ": "
+                << s.bytes / (1 << 20) << ", " << s.bytes_max / (1 << 20) << ", " << s.arrays << std::endl;
+          std::cerr << tmp.str();
+        }
+
+        // high-water mark of the resident memory of the process, including what is not accounted
+        // for in memory_usage() (expression temporaries, halo buffers, MPI, output)
+        void print_peak_memory()
+        {
+          struct rusage ru;
+          getrusage(RUSAGE_SELF, &ru);
+#if defined(__APPLE__)
+          std::vector<double> peak{double(ru.ru_maxrss)}; // bytes
+#else
+          std::vector<double> peak{double(ru.ru_maxrss) * 1024}; // kilobytes
+#endif
+          mem->distmem.max(peak);
+          if (mem->distmem.rank() != 0) return;
+          std::cerr << " peak resident memory: " << peak[0] / (1 << 20) << " MiB (the largest of a process)" << std::endl;
+        }
+
+        void print_hw_counts()
+        {
+          const auto stats = hw_counts();
+          if (mem->distmem.rank() != 0) return;
+
+          std::ostringstream tmp;
+          if (!algos[0].hw_error().empty())
+          {
+            tmp << " hardware counters not available (" << algos[0].hw_error() << ")" << std::endl;
+            std::cerr << tmp.str();
+            return;
+          }
+
+          // summed over threads and processes
+          std::map<std::string, std::pair<double, hw_counts_t>> sums;
+          for (const auto &s : stats)
+          {
+            auto &sum = sums[s.path];
+            sum.first += s.time;
+            for (int e = 0; e < hw_n_events; ++e) sum.second[e] += s.counts[e];
+          }
+
+          tmp << " hardware counters (over threads and processes: cycles, instructions, instructions per cycle,"
+              << " last-level cache misses per 1000 instructions, memory traffic [GB/s] of a thread assuming 64 B per miss):" << std::endl;
+          for (const auto &s : sums)
+          {
+            const auto depth = std::count(s.first.begin(), s.first.end(), '/');
+            const auto name = s.first.substr(s.first.rfind('/') + 1);
+            const auto &c = s.second.second;
+            tmp << std::string(2 * depth + 2, ' ') << name << ": "
+                << c[hw_cycles] << ", " << c[hw_instructions] << ", " << c[hw_instructions] / c[hw_cycles] << ", "
+                << 1000 * c[hw_llc_misses] / c[hw_instructions] << ", " << 64e-9 * c[hw_llc_misses] / s.second.first << std::endl;
+          }
+          std::cerr << tmp.str();
+        }
+
         public:
 
         void advance(advance_arg_t nt) final
         {
+          const bool measure = slab_rebalance && mem->size > 1;
+          if (measure)
+          {
+            std::fill(mem->barrier_wait.begin(), mem->barrier_wait.end(), 0.);
+            mem->barrier_timing = true;
+          }
+
           tmr.resume();
+          const auto t0 = std::chrono::steady_clock::now();
           solve(nt);
+          const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
           tmr.stop();
+
+          if (measure)
+          {
+            mem->barrier_timing = false;
+            rebalance(wall);
+          }
+        }
+
+        std::map<std::string, phase_stats_t> phase_timings() final
+        {
+          std::map<std::string, phase_stats_t> res;
+          if (!solver_t::ct_params_t_::phase_timers) return res;
+
+          std::vector<std::map<std::string, std::pair<double, long long>>> thrds;
+          std::vector<std::string> paths;
+          for (const auto &a : algos)
+          {
+            thrds.push_back(a.phase_results());
+            for (const auto &r : thrds.back()) paths.push_back(r.first);
+          }
+          // the same regions in all processes, as needed by the reductions below
+          mem->distmem.merge(paths);
+
+          const int n = paths.size();
+          std::vector<double>
+            mins(n, std::numeric_limits<double>::max()),
+            maxs(n, 0), sums(n, 0), counts(n, 0);
+          for (int i = 0; i < n; ++i)
+          {
+            for (const auto &t : thrds)
+            {
+              const auto r = t.find(paths[i]);
+              const double time = r == t.end() ? 0 : r->second.first;
+              mins[i] = std::min(mins[i], time);
+              maxs[i] = std::max(maxs[i], time);
+              sums[i] += time;
+              if (r != t.end()) counts[i] += r->second.second;
+            }
+          }
+          mem->distmem.min(mins);
+          mem->distmem.max(maxs);
+          mem->distmem.sum(sums);
+          mem->distmem.sum(counts);
+          const double n_thrds = mem->distmem.sum(double(algos.size()));
+
+          for (int i = 0; i < n; ++i)
+          {
+            auto &r = res[paths[i]];
+            r.min = mins[i];
+            r.avg = sums[i] / n_thrds;
+            r.max = maxs[i];
+            r.count = counts[i];
+          }
+          return res;
+        }
+
+        std::vector<hw_stats_t> hw_counts() final
+        {
+          std::vector<hw_stats_t> res;
+          if (!hw_report) return res;
+
+          std::vector<std::map<std::string, hw_counts_t>> thrds;
+          std::vector<std::map<std::string, std::pair<double, long long>>> times;
+          std::vector<std::string> paths;
+          for (const auto &a : algos)
+          {
+            thrds.push_back(a.hw_results());
+            times.push_back(a.phase_results());
+            for (const auto &r : thrds.back()) paths.push_back(r.first);
+          }
+          // the same regions in all processes, as needed by the reduction below
+          mem->distmem.merge(paths);
+
+          // time and counts in a slot for each region, process and thread, filled by the owning
+          // process and summed (same thread count in all processes assumed)
+          const int n = paths.size(), size = algos.size(), n_procs = mem->distmem.size(), n_vals = 1 + hw_n_events;
+          std::vector<double> vals(n * n_procs * size * n_vals, 0);
+          for (int i = 0; i < n; ++i)
+          {
+            for (int t = 0; t < size; ++t)
+            {
+              const auto r = thrds[t].find(paths[i]);
+              if (r == thrds[t].end()) continue;
+              const auto v = vals.begin() + ((i * n_procs + mem->distmem.rank()) * size + t) * n_vals;
+              v[0] = times[t].at(paths[i]).first;
+              std::copy(r->second.begin(), r->second.end(), v + 1);
+            }
+          }
+          mem->distmem.sum(vals);
+
+          for (int i = 0; i < n; ++i)
+          {
+            for (int p = 0; p < n_procs; ++p)
+            {
+              for (int t = 0; t < size; ++t)
+              {
+                const auto v = vals.begin() + ((i * n_procs + p) * size + t) * n_vals;
+                hw_stats_t r;
+                r.path = paths[i];
+                r.rank = p;
+                r.thread = t;
+                r.time = v[0];
+                std::copy(v + 1, v + n_vals, r.counts.begin());
+                res.push_back(r);
+              }
+            }
+          }
+          return res;
+        }
+
+        std::vector<mem_stats_t> memory_usage() final
+        {
+          return mem->memory_usage();
+        }
+
+        std::vector<barrier_stats_t> barrier_profile() final
+        {
+          std::vector<barrier_stats_t> res;
+          if (!mem->barrier_profiling) return res;
+
+          // by "file:line" (the same file may be given by different pointers in different translation units)
+          const int size = mem->size;
+          std::vector<std::map<std::string, typename mem_t::barrier_site_t>> thrds(size);
+          std::vector<std::string> sites;
+          for (int t = 0; t < size; ++t)
+          {
+            for (const auto &s : mem->barrier_sites[t])
+            {
+              const auto name = std::string(s.first.first) + ":" + std::to_string(s.first.second);
+              auto &site = thrds[t][name];
+              site.count += s.second.count;
+              site.wait += s.second.wait;
+              site.max_wait = std::max(site.max_wait, s.second.max_wait);
+              sites.push_back(name);
+            }
+          }
+          // the same sites in all processes, as needed by the reductions below
+          mem->distmem.merge(sites);
+
+          // same thread count in all processes assumed
+          const int n = sites.size();
+          std::vector<double>
+            counts(n, 0), wait_sum(n, 0), max_wait(n, 0), thrd_wait(n * size, 0),
+            wait_min(n, std::numeric_limits<double>::max()), wait_max(n, 0);
+          for (int i = 0; i < n; ++i)
+          {
+            for (int t = 0; t < size; ++t)
+            {
+              const auto s = thrds[t].find(sites[i]);
+              const double wait = s == thrds[t].end() ? 0 : s->second.wait;
+              wait_min[i] = std::min(wait_min[i], wait);
+              wait_max[i] = std::max(wait_max[i], wait);
+              wait_sum[i] += wait;
+              thrd_wait[i * size + t] = wait;
+              if (s == thrds[t].end()) continue;
+              counts[i] += s->second.count;
+              max_wait[i] = std::max(max_wait[i], s->second.max_wait);
+            }
+          }
+          mem->distmem.sum(counts);
+          mem->distmem.sum(wait_sum);
+          mem->distmem.sum(thrd_wait);
+          mem->distmem.min(wait_min);
+          mem->distmem.max(wait_max);
+          mem->distmem.max(max_wait);
+          const double n_thrds = mem->distmem.sum(double(size));
+          const double n_steps = std::max(algos[0].timestep_(), 1LL);
+
+          for (int i = 0; i < n; ++i)
+          {
+            barrier_stats_t r;
+            r.site = sites[i];
+            r.calls_per_step = counts[i] / n_thrds / n_steps;
+            r.wait_min = wait_min[i];
+            r.wait_avg = wait_sum[i] / n_thrds;
+            r.wait_max = wait_max[i];
+            r.max_wait = max_wait[i];
+            const auto w = thrd_wait.begin() + i * size;
+            r.latest_thread = std::min_element(w, w + size) - w;
+            res.push_back(r);
+          }
+          std::sort(res.begin(), res.end(), [](const barrier_stats_t &a, const barrier_stats_t &b) {
+            return a.wait_avg > b.wait_avg;
+          });
+          return res;
         }
 
         typename solver_t::arr_t advectee(int e = 0) final
@@ -289,6 +803,11 @@ namespace libmpdataxx
 #endif
         }
 
+        typename solver_t::arr_t advectee_root(int e = 0) final
+        {
+          return mem->advectee_root(e);
+        }
+
         void advectee_global_set(const typename solver_t::arr_t arr, int e = 0) final
         {
 #if defined(USE_MPI)
@@ -298,6 +817,11 @@ namespace libmpdataxx
 #endif
         }
 
+        void advectee_local_set(const std::function<void(typename solver_t::arr_t)> &init, int e = 0) final
+        {
+          mem->advectee_local_set(init, e);
+        }
+
         typename solver_t::arr_t advector(int d = 0) final
         {
           return mem->advector(d);
@@ -323,6 +847,20 @@ namespace libmpdataxx
           return mem->sclr_array(name, n);
         }
 
+        void checkpoint(const std::string &path) final
+        {
+          // shared arrays are written by the first thread, the clock is the same in all threads
+          algos[0].checkpoint(path);
+        }
+
+        void restart(const std::string &path) final
+        {
+          algos[0].restart(path);
+          // the thread count may differ from the one at checkpoint
+          for (int i = 1; i < algos.size(); ++i)
+            algos[i].copy_clock(algos[0]);
+        }
+
         bool *panic_ptr() final
         {
           return &this->mem->panic;
@@ -344,5 +882,24 @@ namespace libmpdataxx
         }
       };
     } // namespace detail
+
+    // memory needed by the arrays of a solver (as reported by any::memory_usage() once it is
+    // constructed with the same parameters and number of threads), obtained without allocating them;
+    // the output buffers allocated at construction are not included
+    // with MPI it is collective and, as the process grid is needed, initialises MPI if not done before
+    // (as a solver would, with the thread support required by p.mpi_comm_thread); MPI is then finalised
+    // by the solver constructed next, otherwise MPI_Finalize() has to be called by the caller
+    // (no communication thread is started and no memory is shared between processes)
+    template <class solver_t>
+    std::vector<detail::mem_stats_t> estimate_memory(const typename solver_t::rt_params_t &p, const int size = 1)
+    {
+      detail::sharedmem<
+        typename solver_t::real_t,
+        solver_t::n_dims,
+        solver_t::n_tlev
+      > mem(p.grid_size, size, p.mpi_dims, p.mpi_comm_thread, true);
+      solver_t::alloc(&mem, p.n_iters);
+      return mem.memory_usage();
+    }
   } // namespace concurr
 } // namespace libmpdataxx
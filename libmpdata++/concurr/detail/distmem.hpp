@@ -2,12 +2,24 @@
 
 #if defined(USE_MPI)
 #  include <boost/serialization/vector.hpp>
+#  include <boost/serialization/string.hpp>
 #  include <boost/mpi/communicator.hpp>
 #  include <boost/mpi/collectives.hpp>
+#  include <libmpdata++/concurr/detail/comm_thread.hpp>
+#  include <libmpdata++/concurr/detail/tracer.hpp>
 #else
 #  include <cstdlib>
 #endif
 
+#include <map>
+#include <array>
+#include <string>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+
 
 namespace libmpdataxx
 {
@@ -22,6 +34,17 @@ namespace libmpdataxx
       };
 #endif
 
+      // the default process grid: domain divided among processes in the first dimension only,
+      // zeros are filled in by MPI_Dims_create
+      template <int n_dims>
+      std::array<int, n_dims> default_mpi_dims()
+      {
+        std::array<int, n_dims> res;
+        res.fill(1);
+        res[0] = 0;
+        return res;
+      }
+
       template <typename real_t, int n_dims>
       class distmem
       {
@@ -37,7 +60,7 @@ public: // TODO: just a temp measure, make it private again
         {
 #if defined(USE_MPI)
           reduce_real_t res;
-          boost::mpi::all_reduce(mpicom, val, res, Op()); // it's thread-safe?
+          mpi_call([&]{ boost::mpi::all_reduce(mpicom, val, res, Op()); }); // it's thread-safe?
           return res;
 #else
           return val;
@@ -45,14 +68,81 @@ public: // TODO: just a temp measure, make it private again
         }
 
 
+        // element-wise reduction of a vector across processes, done in place
+        template <typename Op, typename reduce_real_t>
+        void reduce_hlpr(std::vector<reduce_real_t> &vals)
+        {
+#if defined(USE_MPI)
+          std::vector<reduce_real_t> res(vals.size());
+          mpi_call([&]{ boost::mpi::all_reduce(mpicom, vals.data(), vals.size(), res.data(), Op()); });
+          vals.swap(res);
+#endif
+        }
+
+#if defined(USE_MPI)
+        int rank_, size_;
+
+        // if set, all MPI communication done during the time stepping goes through this thread
+        std::unique_ptr<comm_thread> comm;
+
+        // processes on the same node (sharing memory)
+        MPI_Comm shmcom = MPI_COMM_NULL;
+        std::vector<int> shm_ranks; // rank in shmcom of each process (MPI_UNDEFINED if on other node)
+#endif
+
         public:
 
+#if defined(USE_MPI)
+        // if set, the time spent by the calling threads in MPI is recorded (see sharedmem_common::trace)
+        tracer *trace = nullptr;
+
+        // if set, remote halos are exchanged with subarray datatypes and persistent requests (see remote_common)
+        bool persistent_xchng = false;
+
+        // post() starts the communication and wait() completes it, with a communication thread
+        // both are done by this thread (test() being called repeatedly instead of wait())
+        void mpi_call(
+          const std::function<void()> &post,
+          const std::function<bool()> &test,
+          const std::function<void()> &wait
+        ) const
+        {
+          const tracer::scope region(trace, "mpi_wait");
+          if (comm) comm->run(post, test);
+          else
+          {
+            post();
+            wait();
+          }
+        }
+
+        // a blocking call (e.g. a collective)
+        void mpi_call(const std::function<void()> &call) const
+        {
+          const tracer::scope region(trace, "mpi_call");
+          if (comm) comm->run(call, []{ return true; });
+          else call();
+        }
+
+        // an array allocated in a memory window shared by the processes on the same node
+        struct shm_arr_t
+        {
+          MPI_Win win;
+          std::vector<real_t*> ptrs;                       // first element of the array in each process of the node
+          std::vector<std::array<int, 2 * n_dims>> geoms;  // lbound and extent in each dimension in each process
+        };
+        std::map<const real_t*, shm_arr_t> shm_arrs; // by the first element in this process
+#endif
+
         std::array<int, n_dims> grid_size;
 
+        // Cartesian process grid: number of processes in each dimension and coordinates of this process
+        std::array<int, n_dims> dims, coords;
+
         int rank()
         {
 #if defined(USE_MPI)
-          return mpicom.rank();  // is it thread-safe? TODO: init once in ctor?
+          return rank_;
 #else
           return 0;
 #endif
@@ -61,7 +151,7 @@ public: // TODO: just a temp measure, make it private again
         int size()
         {
 #if defined(USE_MPI)
-          return mpicom.size();   // is it thread-safe? TODO: init once in ctor?
+          return size_;
 #else
           return 1;
 #endif
@@ -70,7 +160,7 @@ public: // TODO: just a temp measure, make it private again
         void barrier()
         {
 #if defined(USE_MPI)
-          mpicom.barrier();
+          mpi_call([&]{ mpicom.barrier(); });
 #else
           assert(false);
 #endif
@@ -95,16 +185,140 @@ public: // TODO: just a temp measure, make it private again
         }
 
         // sum always done on doubles
-        // TODO: option to run more accurate summation (e.g. in pressure solver), see https://link.springer.com/content/pdf/10.1023/A:1008153532043.pdf
+        // (see sharedmem_common::sum_repro for summation independent of the numbers of threads and processes)
         double sum(const double &val)
         {
           return reduce_hlpr<std::plus<double>>(val);
         }
 
+        // element-wise versions of the above, for vectors of values (e.g. vertical profiles)
+        void sum(std::vector<double> &vals)
+        {
+          reduce_hlpr<std::plus<double>>(vals);
+        }
+
+        // exact, used by sharedmem_common::sum_repro
+        void sum(std::vector<long long> &vals)
+        {
+          reduce_hlpr<std::plus<long long>>(vals);
+        }
+
+        void min(std::vector<double> &vals)
+        {
+#if defined(USE_MPI)
+          reduce_hlpr<boost::mpi::minimum<double>>(vals);
+#endif
+        }
+
+        void max(std::vector<double> &vals)
+        {
+#if defined(USE_MPI)
+          reduce_hlpr<boost::mpi::maximum<double>>(vals);
+#endif
+        }
+
+        // union of the sets of strings (e.g. names of timed regions) of all processes, sorted
+        void merge(std::vector<std::string> &strs)
+        {
+#if defined(USE_MPI)
+          std::vector<std::vector<std::string>> all;
+          mpi_call([&]{ boost::mpi::all_gather(mpicom, strs, all); });
+          for (const auto &v : all) strs.insert(strs.end(), v.begin(), v.end());
+#endif
+          std::sort(strs.begin(), strs.end());
+          strs.erase(std::unique(strs.begin(), strs.end()), strs.end());
+        }
+
+        // rank of the neighbour in dimension d (dir = -1 for left, +1 for right), periodic
+        int peer(const int d, const int dir)
+        {
+#if defined(USE_MPI)
+          int src, dst;
+          mpi_call([&]{ MPI_Cart_shift(mpicom, d, dir, &src, &dst); });
+          return dst;
+#else
+          return 0;
+#endif
+        }
+
+        // coordinates in the process grid of a given rank
+        std::array<int, n_dims> coords_of(const int rank)
+        {
+          std::array<int, n_dims> res;
+#if defined(USE_MPI)
+          mpi_call([&]{ MPI_Cart_coords(mpicom, rank, n_dims, res.data()); });
+#else
+          res.fill(0);
+#endif
+          return res;
+        }
+
+        // rank on the node of a process given by its rank, -1 if on other node (or if not sharing memory)
+        int shm_rank(const int rank) const
+        {
+#if defined(USE_MPI)
+          return shm_ranks.empty() || shm_ranks.at(rank) == MPI_UNDEFINED ? -1 : shm_ranks.at(rank);
+#else
+          return -1;
+#endif
+        }
+
+        // allocation of an array (contiguous, C-ordered) in a window shared by the processes on the node,
+        // collective within the node; returns nullptr if there is no other process on the node
+        real_t *shm_alloc(
+          const std::array<int, n_dims> &lbound,
+          const std::array<int, n_dims> &extent
+        )
+        {
+#if defined(USE_MPI)
+          if (shm_ranks.empty()) return nullptr;
+
+          MPI_Aint n = 1;
+          for (int d = 0; d < n_dims; ++d) n *= extent[d];
+
+          shm_arr_t arr;
+          real_t *ptr;
+          MPI_Win_allocate_shared(n * sizeof(real_t), sizeof(real_t), MPI_INFO_NULL, shmcom, &ptr, &arr.win);
+          // passive target epoch for the whole lifetime of the window, synchronisation with MPI_Win_sync
+          MPI_Win_lock_all(MPI_MODE_NOCHECK, arr.win);
+
+          int shm_size;
+          MPI_Comm_size(shmcom, &shm_size);
+          arr.ptrs.resize(shm_size);
+          arr.geoms.resize(shm_size);
+          for (int r = 0; r < shm_size; ++r)
+          {
+            MPI_Aint size;
+            int disp;
+            MPI_Win_shared_query(arr.win, r, &size, &disp, &arr.ptrs[r]);
+          }
+
+          std::array<int, 2 * n_dims> geom;
+          for (int d = 0; d < n_dims; ++d)
+          {
+            geom[2 * d] = lbound[d];
+            geom[2 * d + 1] = extent[d];
+          }
+          MPI_Allgather(geom.data(), 2 * n_dims, MPI_INT, arr.geoms.data(), 2 * n_dims, MPI_INT, shmcom);
+
+          shm_arrs.emplace(ptr, arr);
+          return ptr;
+#else
+          return nullptr;
+#endif
+        }
+
         // ctor
-        distmem(const std::array<int, n_dims> &grid_size)
+        distmem(
+          const std::array<int, n_dims> &grid_size,
+          const std::array<int, n_dims> &mpi_dims = default_mpi_dims<n_dims>(),
+          const bool use_comm_thread = false,
+          const bool dry_run = false // only the process grid is set up (see concurr::estimate_memory)
+        )
           : grid_size(grid_size)
         {
+          dims.fill(1);
+          coords.fill(0);
 #if !defined(USE_MPI)
           if (
             // mvapich2
@@ -120,16 +334,94 @@ public: // TODO: just a temp measure, make it private again
           // init mpi here, since distmem is constructed before hdf5
           // will be finalized in slvr_common dtor, since distmem is destructed before hdf5;
           // boost::mpi::enviro being global var caused deadlocks when freeing memory
+          // with the communication thread only one thread calls MPI at a time
           if(!MPI::Is_initialized())
           {
             mpi_initialized_before = false;
-            MPI::Init_thread(MPI_THREAD_MULTIPLE);
+            MPI::Init_thread(use_comm_thread ? MPI_THREAD_SERIALIZED : MPI_THREAD_MULTIPLE);
           }
-          if (boost::mpi::environment::thread_level() != boost::mpi::threading::multiple)
+          if (use_comm_thread)
+          {
+            if (boost::mpi::environment::thread_level() < boost::mpi::threading::serialized)
+              throw std::runtime_error("failed to initialise MPI environment with MPI_THREAD_SERIALIZED");
+          }
+          else if (boost::mpi::environment::thread_level() != boost::mpi::threading::multiple)
           {
             throw std::runtime_error("failed to initialise MPI environment with MPI_THREAD_MULTIPLE");
           }
-          mpicom = boost::mpi::communicator(MPI_COMM_WORLD, boost::mpi::comm_duplicate); // use a duplicate of MPI_COMM_WORLD, can't construct it before MPI_Init call (?)
+
+          // Cartesian topology (periodic, the remote bconds decide if the edges communicate),
+          // no reordering so that ranks are the same as in MPI_COMM_WORLD (used e.g. by the remote bconds)
+          int world_size;
+          MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+          int fixed = 1;
+          for (int d = 0; d < n_dims; ++d)
+          {
+            if (mpi_dims[d] < 0)
+              throw std::runtime_error("negative number of processes in the process grid");
+            if (mpi_dims[d] > 0) fixed *= mpi_dims[d];
+          }
+          if (world_size % fixed != 0)
+            throw std::runtime_error("number of processes not compatible with the requested process grid");
+
+          dims = mpi_dims;
+          MPI_Dims_create(world_size, n_dims, dims.data());
+
+          std::array<int, n_dims> periods;
+          periods.fill(1);
+          MPI_Comm cart;
+          MPI_Cart_create(MPI_COMM_WORLD, n_dims, dims.data(), periods.data(), 0, &cart);
+          mpicom = boost::mpi::communicator(cart, boost::mpi::comm_take_ownership); // can't construct it before MPI_Init call (?)
+          rank_ = mpicom.rank();
+          size_ = mpicom.size();
+          MPI_Cart_coords(mpicom, rank_, n_dims, coords.data());
+
+          // neither the memory shared by the processes on the same node nor the communication thread
+          // are needed if nothing is allocated
+          if (!dry_run)
+          {
+            // processes on the same node, halos of arrays allocated with shm_alloc() are read directly
+            // (see the remote bconds); not used if there is only one process per node
+            MPI_Comm_split_type(mpicom, MPI_COMM_TYPE_SHARED, mpicom.rank(), MPI_INFO_NULL, &shmcom);
+            int shm_size;
+            MPI_Comm_size(shmcom, &shm_size);
+            if (shm_size > 1)
+            {
+              MPI_Group grp, shm_grp;
+              MPI_Comm_group(mpicom, &grp);
+              MPI_Comm_group(shmcom, &shm_grp);
+              std::vector<int> ranks(mpicom.size());
+              for (int r = 0; r < mpicom.size(); ++r) ranks[r] = r;
+              shm_ranks.resize(mpicom.size());
+              MPI_Group_translate_ranks(grp, mpicom.size(), ranks.data(), shm_grp, shm_ranks.data());
+              MPI_Group_free(&grp);
+              MPI_Group_free(&shm_grp);
+            }
+
+            // started last, the calls above are done by the calling thread
+            if (use_comm_thread) comm.reset(new comm_thread());
+          }
+#endif
+          for (int d = 0; d < n_dims; ++d)
+            if (dims[d] > grid_size[d])
+              throw std::runtime_error("number of subdomains greater than number of gridpoints");
+        }
+
+        // dtor
+        ~distmem()
+        {
+#if defined(USE_MPI)
+          comm.reset();
+
+          int finalized;
+          MPI_Finalized(&finalized);
+          if (finalized) return; // the windows are freed by MPI_Finalize
+          for (auto &a : shm_arrs)
+          {
+            MPI_Win_unlock_all(a.second.win);
+            MPI_Win_free(&a.second.win);
+          }
+          if (shmcom != MPI_COMM_NULL) MPI_Comm_free(&shmcom);
 #endif
         }
       };
@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief per-thread hardware performance counters (cycles, instructions, last-level cache misses)
+ *   read with Linux perf_event_open at the boundaries of the timed regions (see phase_timers),
+ *   enabled with rt_params_t::hw_counters; if the counters cannot be opened (other systems,
+ *   containers, perf_event_paranoid, virtual machines without a PMU) they are reported as not available
+ */
+
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      enum hw_event_e { hw_cycles, hw_instructions, hw_llc_misses, hw_n_events };
+
+      using hw_counts_t = std::array<double, hw_n_events>;
+
+      // hardware counters of a timed region in a thread of a process (NaN if not available),
+      // see concurr::any::hw_counts()
+      struct hw_stats_t
+      {
+        std::string path;
+        int rank = 0, thread = 0;
+        double time = 0;
+        hw_counts_t counts;
+      };
+
+      // counters of the calling thread, open between start() and stop() which have to be called
+      // by the thread that is measured (the same solver may be run by different threads in subsequent solve() calls)
+      class hw_counters
+      {
+        std::array<int, hw_n_events> fds, pos; // file descriptors and positions in the group read, -1 if not available
+        int n_open = 0;
+        std::string err;
+
+        public:
+
+        hw_counters()
+        {
+          fds.fill(-1);
+          pos.fill(-1);
+        }
+
+        hw_counters(const hw_counters &) = delete;
+
+        ~hw_counters()
+        {
+          stop();
+        }
+
+        bool active() const
+        {
+          return fds[hw_cycles] != -1;
+        }
+
+        bool available(const int e) const
+        {
+          return fds[e] != -1;
+        }
+
+        // reason for the counters not being available
+        const std::string &error() const
+        {
+          return err;
+        }
+
+#if defined(__linux__)
+        void start()
+        {
+          stop(); // e.g. left open by an exception thrown from a previous solve()
+          err.clear();
+          const std::array<std::uint64_t, hw_n_events> configs = {{
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES // usually mapped to the last-level cache
+          }};
+
+          // cycles lead the group, all events being scheduled together
+          for (int e = 0; e < hw_n_events; ++e)
+          {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = e == hw_cycles;
+            attr.exclude_kernel = 1; // allowed with perf_event_paranoid up to 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int fd = syscall(__NR_perf_event_open, &attr, 0, -1, e == hw_cycles ? -1 : fds[hw_cycles], 0);
+            if (fd == -1)
+            {
+              if (e == hw_cycles)
+              {
+                err = std::string("perf_event_open: ") + std::strerror(errno);
+                return;
+              }
+              continue; // e.g. no cache events in a virtual machine
+            }
+            fds[e] = fd;
+            pos[e] = n_open++;
+          }
+
+          ioctl(fds[hw_cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+          ioctl(fds[hw_cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+
+        void stop()
+        {
+          // members closed before the leader
+          for (int e = hw_n_events - 1; e >= 0; --e)
+          {
+            if (fds[e] != -1) close(fds[e]);
+            fds[e] = pos[e] = -1;
+          }
+          n_open = 0;
+        }
+
+        // counts since start(), scaled if the group was multiplexed with other events; NaN if not available
+        bool read(hw_counts_t &res) const
+        {
+          res.fill(std::numeric_limits<double>::quiet_NaN());
+          if (!active()) return false;
+
+          std::array<std::uint64_t, 3 + hw_n_events> buf; // number of events, time enabled, time running, values
+          if (::read(fds[hw_cycles], buf.data(), sizeof(buf)) < ssize_t((3 + n_open) * sizeof(std::uint64_t))) return false;
+          const double scale = buf[2] > 0 ? double(buf[1]) / buf[2] : 0;
+          for (int e = 0; e < hw_n_events; ++e)
+            if (pos[e] != -1) res[e] = buf[3 + pos[e]] * scale;
+          return true;
+        }
+#else
+        void start()
+        {
+          err = "hardware counters available on Linux only";
+        }
+
+        void stop() {}
+
+        bool read(hw_counts_t &res) const
+        {
+          res.fill(std::numeric_limits<double>::quiet_NaN());
+          return false;
+        }
+#endif
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
@@ -0,0 +1,30 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief memory used by the solver arrays, see concurr::any::memory_usage() and concurr::estimate_memory()
+ */
+
+#pragma once
+
+#include <string>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // arrays allocated for a purpose (e.g. "psi", "GC", "tmp" or the name of a temporary field)
+      // by a file (see sharedmem_common::old), over all processes
+      struct mem_stats_t
+      {
+        std::string file, purpose;
+        int arrays = 0;        // in a process (the largest number)
+        double bytes = 0;      // summed over processes
+        double bytes_max = 0;  // in the process using the most
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
@@ -0,0 +1,217 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief per-thread timers of the phases of the solver (advection, halo exchange, output, ...),
+ *   enabled with ct_params_t::phase_timers, see solver_common::timed_region() and concurr::any::phase_timings()
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <libmpdata++/concurr/detail/hw_counters.hpp>
+#include <libmpdata++/concurr/detail/tracer.hpp>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // time spent in a region by a thread, over all threads of all processes
+      // (threads that never entered the region count as zero), and the total number of calls
+      struct phase_stats_t
+      {
+        double min = 0, avg = 0, max = 0;
+        long long count = 0;
+      };
+
+      // a tree of regions of a single thread, regions are identified by their path
+      // from the root, e.g. "solve_loop_body/advop/xchng_sclr"
+      class phase_timers
+      {
+        using clock_t = std::chrono::steady_clock;
+
+        struct node_t
+        {
+          const char *name;
+          int parent;
+          double time = 0;
+          long long count = 0;
+          clock_t::time_point t0;
+          hw_counts_t hw, hw0;
+          std::vector<int> children;
+
+          node_t(const char *name, const int parent) : name(name), parent(parent)
+          {
+            hw.fill(0);
+          }
+        };
+
+        std::vector<node_t> nodes = {node_t("", -1)};
+        int current = 0;
+
+        std::string path(int n) const
+        {
+          std::string res = nodes[n].name;
+          for (n = nodes[n].parent; n > 0; n = nodes[n].parent)
+            res = std::string(nodes[n].name) + "/" + res;
+          return res;
+        }
+
+        // read at the boundaries of the regions if enabled and available
+        bool hw_enabled = false;
+        hw_counters hw;
+        std::array<bool, hw_n_events> hw_seen = {}; // if ever counted
+
+        public:
+
+        void count_hw(const bool enabled)
+        {
+          hw_enabled = enabled;
+        }
+
+        // to be called by the thread running the solver at the beginning and end of solve()
+        void hw_start()
+        {
+          if (!hw_enabled) return;
+          hw.start();
+          for (int e = 0; e < hw_n_events; ++e) hw_seen[e] = hw_seen[e] || hw.available(e);
+        }
+
+        void hw_stop()
+        {
+          hw.stop();
+        }
+
+        const hw_counters &hw_state() const
+        {
+          return hw;
+        }
+
+        void begin(const char *name)
+        {
+          int child = -1;
+          for (const int c : nodes[current].children)
+          {
+            // names are string literals, comparing pointers first
+            if (nodes[c].name == name || std::strcmp(nodes[c].name, name) == 0)
+            {
+              child = c;
+              break;
+            }
+          }
+          if (child == -1)
+          {
+            child = nodes.size();
+            nodes.emplace_back(name, current);
+            nodes[current].children.push_back(child);
+          }
+          current = child;
+          nodes[current].t0 = clock_t::now();
+          if (hw.active()) hw.read(nodes[current].hw0);
+        }
+
+        void end()
+        {
+          auto &n = nodes[current];
+          if (hw.active())
+          {
+            hw_counts_t c;
+            hw.read(c);
+            for (int e = 0; e < hw_n_events; ++e) n.hw[e] += c[e] - n.hw0[e];
+          }
+          n.time += std::chrono::duration<double>(clock_t::now() - n.t0).count();
+          ++n.count;
+          current = n.parent;
+        }
+
+        void reset()
+        {
+          for (auto &n : nodes)
+          {
+            n.time = 0;
+            n.count = 0;
+            n.hw.fill(0);
+          }
+        }
+
+        // time and number of calls of each region, by path
+        std::map<std::string, std::pair<double, long long>> results() const
+        {
+          std::map<std::string, std::pair<double, long long>> res;
+          for (int n = 1; n < int(nodes.size()); ++n)
+            res[path(n)] = {nodes[n].time, nodes[n].count};
+          return res;
+        }
+
+        // hardware counts of each region, by path (NaN for the events never counted)
+        std::map<std::string, hw_counts_t> hw_results() const
+        {
+          std::map<std::string, hw_counts_t> res;
+          for (int n = 1; n < int(nodes.size()); ++n)
+          {
+            auto &r = res[path(n)];
+            for (int e = 0; e < hw_n_events; ++e)
+              r[e] = hw_seen[e] ? nodes[n].hw[e] : std::numeric_limits<double>::quiet_NaN();
+          }
+          return res;
+        }
+      };
+
+      // the traced part of a phase_scope, nothing with traced == false
+      template <bool traced>
+      struct trace_scope
+      {
+        trace_scope(tracer *, const char *, const int) {}
+      };
+
+      template <>
+      struct trace_scope<true> : tracer::scope
+      {
+        using tracer::scope::scope;
+      };
+
+      // a region timed from construction to destruction (if timed) and recorded in the timeline
+      // (if traced and the timeline is written, see tracer), an empty type if neither
+      template <bool timed, bool traced>
+      class phase_scope : trace_scope<traced>
+      {
+        public:
+        phase_scope(phase_timers &, const char *name, tracer *trc, const int arg = -1) : trace_scope<traced>(trc, name, arg) {}
+      };
+
+      template <bool traced>
+      class phase_scope<true, traced> : trace_scope<traced>
+      {
+        phase_timers *tmrs;
+
+        public:
+
+        phase_scope(phase_timers &tmrs, const char *name, tracer *trc, const int arg = -1) : trace_scope<traced>(trc, name, arg), tmrs(&tmrs)
+        {
+          tmrs.begin(name);
+        }
+
+        phase_scope(const phase_scope &) = delete;
+        phase_scope(phase_scope &&o) : trace_scope<traced>(std::move(o)), tmrs(o.tmrs)
+        {
+          o.tmrs = nullptr;
+        }
+
+        ~phase_scope()
+        {
+          if (tmrs != nullptr) tmrs->end();
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
@@ -0,0 +1,124 @@
+/** @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief summation with a result independent of the order of summation
+ *   (hence of the numbers of threads and processes), see sharedmem_common::sum_repro()
+ */
+
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // each value is split into n_folds integers, each one holding the next bits of the value
+      // counted from a bound common to all summands; integer sums are exact, so partial sums
+      // (e.g. from threads or processes) can be added in any order giving bitwise identical results
+      // (note: unlike floating-point tricks of this kind, -ffast-math cannot break it)
+      template <int n_folds = 3>
+      class repro_sum
+      {
+        static_assert(n_folds > 0, "n_folds <= 0");
+
+        // counters of non-finite summands, kept after the folds
+        enum { n_nan = n_folds, n_pinf, n_ninf };
+
+        int exp = 0, bits;
+        double scale = 0, fold_scale, bound;
+
+        // bit tests, as std::isfinite() and std::isnan() may be optimised away with -ffast-math
+        static std::uint64_t to_bits(const double x)
+        {
+          std::uint64_t b;
+          std::memcpy(&b, &x, sizeof(b));
+          return b;
+        }
+
+        static bool is_finite(const double x)
+        {
+          return (to_bits(x) & 0x7ff0000000000000ULL) != 0x7ff0000000000000ULL;
+        }
+
+        static bool is_nan(const double x)
+        {
+          return !is_finite(x) && (to_bits(x) & 0x000fffffffffffffULL) != 0;
+        }
+
+        public:
+
+        using acc_t = std::array<long long, n_folds + 3>;
+        acc_t acc;
+
+        // max_abs: maximum of absolute values of all summands (across all threads and processes)
+        // n_max: upper bound for the number of summands
+        repro_sum(const double max_abs, const double n_max)
+        {
+          acc.fill(0);
+          // sum of n_max values smaller than 2^bits has to fit in a long long
+          bits = 62 - int(std::ceil(std::log2(std::max(n_max, 1.))));
+          if (bits < 8) throw std::runtime_error("too many summands for reproducible summation");
+          fold_scale = std::ldexp(1., bits);
+          // a non-finite bound means non-finite summands, finite ones do not matter then
+          if (!is_finite(max_abs))
+          {
+            bound = 0;
+            return;
+          }
+          std::frexp(max_abs, &exp); // max_abs < 2^exp
+          exp = std::max(exp, bits - 1000); // keeping the scale finite for tiny bounds
+          scale = std::ldexp(1., bits - exp);
+          bound = std::ldexp(1., exp);
+        }
+
+        void add(const double x)
+        {
+          if (!is_finite(x))
+          {
+            ++acc[is_nan(x) ? n_nan : x > 0 ? n_pinf : n_ninf];
+            return;
+          }
+          if (bound == 0) return;
+          // the conversions below would be undefined for values not below the bound
+          if (!(std::abs(x) < bound)) throw std::runtime_error("summand above the bound given for reproducible summation");
+
+          double y = x * scale;
+          for (int f = 0; f < n_folds; ++f)
+          {
+            const long long i = static_cast<long long>(y); // truncation, |i| < 2^bits
+            acc[f] += i;
+            y = (y - i) * fold_scale; // the fractional part is exactly representable
+          }
+        }
+
+        void add(const acc_t &other)
+        {
+          for (std::size_t f = 0; f < acc.size(); ++f) acc[f] += other[f];
+        }
+
+        // NaN if any summand was NaN or if both infinities were summed, as for plain summation
+        double result() const
+        {
+          if (acc[n_nan] > 0 || (acc[n_pinf] > 0 && acc[n_ninf] > 0)) return std::numeric_limits<double>::quiet_NaN();
+          if (acc[n_pinf] > 0) return std::numeric_limits<double>::infinity();
+          if (acc[n_ninf] > 0) return -std::numeric_limits<double>::infinity();
+
+          double res = 0;
+          for (int f = n_folds - 1; f >= 0; --f)
+            res += std::ldexp(double(acc[f]), exp - (f + 1) * bits);
+          return res;
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
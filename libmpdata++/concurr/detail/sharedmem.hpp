@@ -12,9 +12,37 @@
 #include <libmpdata++/blitz.hpp>
 #include <libmpdata++/formulae/arakawa_c.hpp>
 #include <libmpdata++/concurr/detail/distmem.hpp>
+#include <libmpdata++/concurr/detail/mem_stats.hpp>
+#include <libmpdata++/concurr/detail/phase_timers.hpp>
+#include <libmpdata++/concurr/detail/repro_sum.hpp>
+#include <libmpdata++/concurr/detail/tracer.hpp>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <memory>
 #include <numeric>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// the call site of sharedmem_common::barrier() passed as default arguments (see barrier_sites)
+#if defined(__clang__)
+#  if __has_builtin(__builtin_FILE) && __has_builtin(__builtin_LINE)
+#    define LIBMPDATAXX_CALLER_FILE __builtin_FILE()
+#    define LIBMPDATAXX_CALLER_LINE __builtin_LINE()
+#  endif
+#elif defined(__GNUC__)
+#  define LIBMPDATAXX_CALLER_FILE __builtin_FILE()
+#  define LIBMPDATAXX_CALLER_LINE __builtin_LINE()
+#endif
+#if !defined(LIBMPDATAXX_CALLER_FILE)
+#  define LIBMPDATAXX_CALLER_FILE "unknown"
+#  define LIBMPDATAXX_CALLER_LINE 0
+#endif
 
 namespace libmpdataxx
 {
@@ -36,6 +64,9 @@ namespace libmpdataxx
 
         std::unique_ptr<blitz::Array<real_t, 1>> xtmtmp;
         std::unique_ptr<blitz::Array<double, 1>> sumtmp;
+        std::unique_ptr<blitz::Array<double, 2>> proftmp;
+        std::vector<double> repro_max;                    // per-thread maxima of absolute values...
+        std::vector<repro_sum<>::acc_t> repro_acc;        // ... and partial sums of sum_repro()
 
         protected:
 
@@ -69,9 +100,70 @@ namespace libmpdataxx
           std::pair<const char*, int>
         > avail_tmp;
 
-        virtual void barrier()
+        // list of temporary fields that are part of the solver state (stored in checkpoints)
+        std::unordered_map<
+          std::string,
+          std::pair<const char*, int>
+        > ckpt_tmp;
+
+        // bytes and number of arrays allocated through old() and old_shared(), by (owning file, purpose)
+        struct mem_use_t
+        {
+          double bytes = 0;
+          int arrays = 0;
+        };
+        std::map<std::pair<std::string, std::string>, mem_use_t> mem_use;
+
+        // if set, the arrays are only accounted for, no memory is allocated (see concurr::estimate_memory)
+        bool dry_run = false;
+
+        // implemented by the concurrency backends
+        virtual void barrier_impl()
+        {
+          assert(false && "sharedmem_common::barrier_impl() called!");
+        }
+
+        // rank of the calling thread (set by the solvers at the beginning of solve())
+        static int &thread_rank()
+        {
+          return detail::thread_rank();
+        }
+
+        // timeline of the solver, set if rt_params_t::trace_path is given (see tracer)
+        std::unique_ptr<tracer> trace;
+
+        // per-thread time spent waiting at barriers, measured if barrier_timing is set
+        bool barrier_timing = false;
+        std::vector<double> barrier_wait;
+
+        // per-thread number of calls and waiting times at each call site of barrier(),
+        // recorded if barrier_profiling is set (see concurr::any::barrier_profile)
+        struct barrier_site_t
         {
-          assert(false && "sharedmem_common::barrier() called!");
+          long long count = 0;
+          double wait = 0, max_wait = 0;
+        };
+        using barrier_sites_t = std::map<std::pair<const char*, int>, barrier_site_t>; // by (file, line)
+        bool barrier_profiling = false;
+        std::vector<barrier_sites_t> barrier_sites;
+
+        void barrier(const char *file = LIBMPDATAXX_CALLER_FILE, const int line = LIBMPDATAXX_CALLER_LINE)
+        {
+          if (!barrier_timing && !barrier_profiling && !trace) return barrier_impl();
+          const auto t0 = std::chrono::steady_clock::now();
+          barrier_impl();
+          const auto t1 = std::chrono::steady_clock::now();
+          const double wait = std::chrono::duration<double>(t1 - t0).count();
+          const int rank = thread_rank();
+          if (trace) trace->record("barrier", t0, t1, line, file);
+          if (barrier_timing) barrier_wait[rank] += wait;
+          if (barrier_profiling)
+          {
+            auto &site = barrier_sites[rank][{file, line}];
+            ++site.count;
+            site.wait += wait;
+            site.max_wait = std::max(site.max_wait, wait);
+          }
         }
 
         void cycle(const int &rank)
@@ -83,29 +175,101 @@ namespace libmpdataxx
 
         // ctors
         // TODO: fill reducetmp with NaNs (or use 1-element arrvec_t - it's NaN-filled by default)
-        sharedmem_common(const std::array<int, n_dims> &grid_size, const int &size)
-          : n(0), distmem(grid_size), size(size) // TODO: is n(0) needed?
+        sharedmem_common(
+          const std::array<int, n_dims> &grid_size,
+          const int &size,
+          const std::array<int, n_dims> &mpi_dims = default_mpi_dims<n_dims>(),
+          const bool mpi_comm_thread = false,
+          const bool dry_run = false
+        )
+          : n(0), distmem(grid_size, mpi_dims, mpi_comm_thread, dry_run), size(size) // TODO: is n(0) needed?
         {
+          this->dry_run = dry_run;
+
+          // subdomain of this process in the Cartesian process grid
           for (int d = 0; d < n_dims; ++d)
           {
             this->grid_size[d] = slab(
               rng_t(0, grid_size[d]-1),
-              d == 0 ? distmem.rank() : 0,
-              d == 0 ? distmem.size() : 1
+              distmem.coords[d],
+              distmem.dims[d]
             );
             origin[d] = this->grid_size[d].first();
           }
 
-          std::ostringstream oss;
-          oss << "grid_size[0]: " << this->grid_size[0] << " origin[0]: " << origin[0] << std::endl;
-          std::cerr << oss.str() << std::endl;
-
           if (size > grid_size[0])
             throw std::runtime_error("number of subdomains greater than number of gridpoints");
 
           if (n_dims != 1)
+          {
             sumtmp.reset(new blitz::Array<double, 1>(this->grid_size[0]));
+            proftmp.reset(new blitz::Array<double, 2>(size, grid_size[n_dims - 1])); // room for all levels of the domain
+          }
           xtmtmp.reset(new blitz::Array<real_t, 1>(size));
+          account(__FILE__, "reductions", (n_dims != 1 ? sumtmp->numElements() + proftmp->numElements() : 0) * sizeof(double) + size * sizeof(real_t));
+          repro_max.resize(size);
+          repro_acc.resize(size);
+          barrier_wait.resize(size);
+          barrier_sites.resize(size);
+        }
+
+        enum prof_op_e { prof_sum, prof_min, prof_max };
+
+        /// @brief concurrency-aware per-level reduction, i.e. over all but the last dimension,
+        ///        slice_op(slice_idx, k) is called for each level k of thread's subdomain and reduces
+        ///        a given slice to a single value, these are then combined across threads and processes with op;
+        ///        returns values for all levels of the whole domain
+        template <class slice_op_t>
+        std::vector<double> prof_reduce(const int &rank, const idx_t<n_dims> &ijk, const slice_op_t &slice_op, const prof_op_e op)
+        {
+          assert(n_dims > 1);
+          // note: it is assumed that the domain is divided among threads in the first dimension only
+          const rng_t &lvls = ijk[n_dims - 1];
+          for (int k = lvls.first(); k <= lvls.last(); ++k)
+          {
+            auto slice_idx = ijk;
+            slice_idx.lbound(n_dims - 1) = k;
+            slice_idx.ubound(n_dims - 1) = k;
+            (*proftmp)(rank, k - lvls.first()) = slice_op(slice_idx, k);
+          }
+          barrier(); // wait for all threads to calc their part
+          const int nz = distmem.grid_size[n_dims - 1];
+          if (rank == 0)
+          {
+            // master thread combines the results from all threads and then from all processes,
+            // levels of other processes (if divided in the vertical) are set to the identity of op
+            const rng_t thrds(0, size - 1);
+            std::vector<double> res(nz,
+              op == prof_min ?  std::numeric_limits<double>::max() :
+              op == prof_max ? -std::numeric_limits<double>::max() :
+              0
+            );
+            for (int k = 0; k < lvls.length(); ++k)
+            {
+              double &r = res[lvls.first() + k];
+              switch (op)
+              {
+                case prof_sum: r = blitz::sum((*proftmp)(thrds, k)); break;
+                case prof_min: r = blitz::min((*proftmp)(thrds, k)); break;
+                case prof_max: r = blitz::max((*proftmp)(thrds, k)); break;
+              }
+            }
+            switch (op)
+            {
+              case prof_sum: this->distmem.sum(res); break;
+              case prof_min: this->distmem.min(res); break;
+              case prof_max: this->distmem.max(res); break;
+            }
+            for (int k = 0; k < nz; ++k)
+              (*proftmp)(0, k) = res[k];
+          }
+          barrier();
+          // propagate the result to all threads of the process
+          std::vector<double> res(nz);
+          for (int k = 0; k < nz; ++k)
+            res[k] = (*proftmp)(0, k);
+          barrier(); // to avoid proftmp being overwritten by next call from other thread
+          return res;
         }
 
         /// @brief concurrency-aware summation of array elements
@@ -195,6 +359,64 @@ namespace libmpdataxx
 #endif
         }
 
+        private:
+
+        template <bool prod>
+        double sum_repro_hlpr(const int &rank, const arr_t &arr1, const arr_t &arr2)
+        {
+          auto val = [](const real_t &a, const real_t &b) { return prod ? double(a) * double(b) : double(a); };
+
+          // common bound of the summands
+          double mx = 0;
+          for (auto i1 = arr1.begin(), i2 = arr2.begin(); i1 != arr1.end(); ++i1, ++i2)
+            mx = std::max(mx, std::abs(val(*i1, *i2)));
+          repro_max[rank] = mx;
+          barrier();
+          if (rank == 0)
+          {
+            for (const auto &m : repro_max) mx = std::max(mx, m);
+            repro_max[0] = this->distmem.max(mx);
+          }
+          barrier();
+
+          // (a bound for the number of summands, the sums are assumed to be over the domain interior)
+          double n_max = 2;
+          for (int d = 0; d < n_dims; ++d) n_max *= this->distmem.grid_size[d];
+          repro_sum<> acc(repro_max[0], n_max);
+          for (auto i1 = arr1.begin(), i2 = arr2.begin(); i1 != arr1.end(); ++i1, ++i2)
+            acc.add(val(*i1, *i2));
+          repro_acc[rank] = acc.acc;
+          barrier();
+          if (rank == 0)
+          {
+            repro_sum<> tot(repro_max[0], n_max);
+            for (const auto &a : repro_acc) tot.add(a);
+            std::vector<long long> vals(tot.acc.begin(), tot.acc.end());
+            this->distmem.sum(vals);
+            std::copy(vals.begin(), vals.end(), repro_acc[0].begin());
+          }
+          barrier();
+          acc.acc = repro_acc[0];
+          const double res = acc.result();
+          barrier(); // to avoid repro_max and repro_acc being overwritten by next call from other thread
+          return res;
+        }
+
+        public:
+
+        /// @brief concurrency-aware summation of array elements with results bitwise identical
+        ///        for any numbers of threads and processes (see repro_sum), costs two passes over the data
+        double sum_repro(const int &rank, const arr_t &arr, const idx_t<n_dims> &ijk)
+        {
+          return sum_repro_hlpr<false>(rank, arr(ijk), arr(ijk));
+        }
+
+        /// @brief as above, for an element-wise product of two arrays
+        double sum_repro(const int &rank, const arr_t &arr1, const arr_t &arr2, const idx_t<n_dims> &ijk)
+        {
+          return sum_repro_hlpr<true>(rank, arr1(ijk), arr2(ijk));
+        }
+
         real_t min(const int &rank, const arr_t &arr)
         {
           // min across local threads
@@ -274,13 +496,108 @@ namespace libmpdataxx
           return ret;
         }
 
-        arr_t *old(arr_t *arg)
+        // what: purpose of the array, file: the one owning it (the caller by default), see mem_use
+        arr_t *old(arr_t *arg, const char *what = "", const char *file = LIBMPDATAXX_CALLER_FILE)
         {
+          account(file, what, double(arg->numElements()) * sizeof(real_t));
           tobefreed.push_back(arg);
           arr_t *ret = never_delete(arg);
           return ret;
         }
 
+        // to be passed to old(): a new array, or in a dry run an array with the same indices but no memory
+        template <class... rngs_t>
+        arr_t *new_arr(const rngs_t&... rngs)
+        {
+          if (!dry_run) return new arr_t(rngs...);
+          return placed(nullptr, {{rngs...}});
+        }
+
+        // allocation in memory shared with other processes on the node (see distmem::shm_alloc),
+        // with a fallback to old(new arr_t(...)) if there are none
+        template <class... rngs_t>
+        arr_t *old_shared(const char *what, const char *file, const rngs_t&... rngs)
+        {
+          const std::array<rng_t, n_dims> r{{rngs...}};
+          if (dry_run) return old(placed(nullptr, r), what, file);
+
+          std::array<int, n_dims> lbound, extent;
+          for (int d = 0; d < n_dims; ++d)
+          {
+            lbound[d] = r[d].first();
+            extent[d] = r[d].length();
+          }
+
+          real_t *ptr = distmem.shm_alloc(lbound, extent);
+          if (ptr == nullptr) return old(new arr_t(rngs...), what, file);
+
+          arr_t *ret = placed(ptr, r);
+          account(file, what, double(ret->numElements()) * sizeof(real_t));
+          return ret;
+        }
+
+        // bytes and number of arrays by file and purpose, over all processes, sorted from the largest, mpi-aware
+        std::vector<mem_stats_t> memory_usage()
+        {
+          // the same components in all processes, as needed by the reductions below
+          std::vector<std::string> keys;
+          for (const auto &u : mem_use) keys.push_back(u.first.first + '\n' + u.first.second);
+          distmem.merge(keys);
+
+          const int n = keys.size();
+          std::vector<double> bytes(n, 0), arrays(n, 0);
+          for (int i = 0; i < n; ++i)
+          {
+            const auto sep = keys[i].find('\n');
+            const auto u = mem_use.find({keys[i].substr(0, sep), keys[i].substr(sep + 1)});
+            if (u == mem_use.end()) continue;
+            bytes[i] = u->second.bytes;
+            arrays[i] = u->second.arrays;
+          }
+          std::vector<double> bytes_max(bytes);
+          distmem.sum(bytes);
+          distmem.max(bytes_max);
+          distmem.max(arrays);
+
+          std::vector<mem_stats_t> res(n);
+          for (int i = 0; i < n; ++i)
+          {
+            const auto sep = keys[i].find('\n');
+            res[i].file = keys[i].substr(0, sep);
+            res[i].purpose = keys[i].substr(sep + 1);
+            res[i].arrays = arrays[i];
+            res[i].bytes = bytes[i];
+            res[i].bytes_max = bytes_max[i];
+          }
+          std::sort(res.begin(), res.end(), [](const mem_stats_t &a, const mem_stats_t &b) {
+            return a.bytes > b.bytes;
+          });
+          return res;
+        }
+
+        private:
+
+        void account(const std::string &file, const std::string &what, const double bytes)
+        {
+          auto &u = mem_use[{file, what}];
+          u.bytes += bytes;
+          u.arrays += 1;
+        }
+
+        // an array spanning ranges r placed at ptr, not owning it
+        arr_t *placed(real_t *ptr, const std::array<rng_t, n_dims> &r)
+        {
+          blitz::TinyVector<int, n_dims> shape, base;
+          for (int d = 0; d < n_dims; ++d)
+          {
+            shape[d] = r[d].length();
+            base[d] = r[d].first();
+          }
+          arr_t *ret = new arr_t(ptr, shape, blitz::neverDeleteData);
+          ret->reindexSelf(base);
+          return ret;
+        }
+
         private:
         // helper methods to define subdomain ranges
         static int min(const int &span, const int &rank, const int &size)
@@ -307,18 +624,176 @@ namespace libmpdataxx
 
         virtual arr_t advectee(int e = 0) = 0;
 
+        // subdomain of a process with given coordinates in the process grid
+        blitz::TinyVector<rng_t, n_dims> distmem_box(const std::array<int, n_dims> &coords)
+        {
+          blitz::TinyVector<rng_t, n_dims> res;
+          for (int d = 0; d < n_dims; ++d)
+            res[d] = slab(rng_t(0, distmem.grid_size[d]-1), coords[d], distmem.dims[d]);
+          return res;
+        }
+
+#if defined(USE_MPI)
+        private:
+
+        // subdomains of all processes
+        std::vector<blitz::TinyVector<rng_t, n_dims>> distmem_boxes()
+        {
+          std::vector<blitz::TinyVector<rng_t, n_dims>> boxes(this->distmem.size());
+          for (int r = 0; r < this->distmem.size(); ++r)
+            boxes[r] = distmem_box(this->distmem.coords_of(r));
+          return boxes;
+        }
+
+        // a subdomain within a contiguous, C-ordered global array
+        MPI_Datatype box_type(const blitz::TinyVector<rng_t, n_dims> &box)
+        {
+          std::array<int, n_dims> sizes, subsizes, starts;
+          for (int d = 0; d < n_dims; ++d)
+          {
+            sizes[d] = this->distmem.grid_size[d];
+            subsizes[d] = box[d].length();
+            starts[d] = box[d].first();
+          }
+          MPI_Datatype type;
+          MPI_Type_create_subarray(n_dims, sizes.data(), subsizes.data(), starts.data(), MPI_ORDER_C, boost::mpi::get_mpi_datatype<real_t>(), &type);
+          MPI_Type_commit(&type);
+          return type;
+        }
+
+        // rank 0 receives the subdomains of all processes directly into (from_root = false),
+        // or sends them directly from (from_root = true) the global array, no global buffers anywhere else
+        void xchng_root(arr_t &global, arr_t &local, const bool from_root)
+        {
+          std::vector<MPI_Datatype> types;
+          std::vector<MPI_Request> reqs;
+          this->distmem.mpi_call(
+            [&]{
+              if (this->distmem.rank() == 0)
+              {
+                const auto boxes = distmem_boxes();
+                for (int r = 1; r < this->distmem.size(); ++r)
+                {
+                  types.push_back(box_type(boxes[r]));
+                  reqs.push_back(MPI_REQUEST_NULL);
+                  if (from_root)
+                    MPI_Isend(global.dataFirst(), 1, types.back(), r, 0, this->distmem.mpicom, &reqs.back());
+                  else
+                    MPI_Irecv(global.dataFirst(), 1, types.back(), r, 0, this->distmem.mpicom, &reqs.back());
+                }
+              }
+              else
+              {
+                reqs.push_back(MPI_REQUEST_NULL);
+                if (from_root)
+                  MPI_Irecv(local.dataFirst(), local.size(), boost::mpi::get_mpi_datatype<real_t>(), 0, 0, this->distmem.mpicom, &reqs.back());
+                else
+                  MPI_Isend(local.dataFirst(), local.size(), boost::mpi::get_mpi_datatype<real_t>(), 0, 0, this->distmem.mpicom, &reqs.back());
+              }
+            },
+            [&]{
+              int done;
+              MPI_Testall(reqs.size(), reqs.data(), &done, MPI_STATUSES_IGNORE);
+              return done != 0;
+            },
+            [&]{ MPI_Waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE); }
+          );
+          for (auto &type : types) MPI_Type_free(&type);
+        }
+
+        public:
+#endif
+
+        // the global advectee on rank 0, an empty array on other ranks
+        arr_t advectee_root(int e = 0)
+        {
+#if defined(USE_MPI)
+          if(this->distmem.size() > 1)
+          {
+            // a contiguous copy of the local part (the advectee has halos)
+            arr_t local(advectee(e).lbound(), advectee(e).extent());
+            local = advectee(e);
+
+            arr_t res;
+            if (this->distmem.rank() == 0)
+            {
+              blitz::TinyVector<int, n_dims> shp;
+              for (int d = 0; d < n_dims; ++d) shp[d] = this->distmem.grid_size[d];
+              res.resize(shp);
+              res(idx_t<n_dims>(distmem_box(this->distmem.coords))) = local;
+            }
+            xchng_root(res, local, false);
+            return res;
+          }
+          else
+#endif
+            return advectee(e);
+        }
+
+        // the global advectee on all ranks
+        const arr_t advectee_global(int e = 0)
+        {
+#if defined(USE_MPI)
+          if(this->distmem.size() > 1)
+          {
+            arr_t res = advectee_root(e);
+            if (this->distmem.rank() != 0)
+            {
+              blitz::TinyVector<int, n_dims> shp;
+              for (int d = 0; d < n_dims; ++d) shp[d] = this->distmem.grid_size[d];
+              res.resize(shp);
+            }
+            this->distmem.mpi_call([&]{ boost::mpi::broadcast(this->distmem.mpicom, res.data(), res.size(), 0); });
+            return res;
+          }
+          else
+#endif
+            return advectee(e);
+        }
+
+        // only the array passed on rank 0 is used (it may be empty on other ranks)
         void advectee_global_set(const arr_t arr, int e = 0)
         {
+          // the subdomains are sent from (or copied out of) arr assuming the global grid shape
+          if (this->distmem.rank() == 0)
+            for (int d = 0; d < n_dims; ++d)
+              if (arr.extent(d) != this->distmem.grid_size[d])
+                throw std::runtime_error("advectee_global_set() called with an array of a shape different from the global grid");
 #if defined(USE_MPI)
           if(this->distmem.size() > 1)
           {
-            advectee(e) = arr(slab(rng_t(0, distmem.grid_size[0]-1), distmem.rank(), distmem.size()));
+            arr_t local(advectee(e).lbound(), advectee(e).extent());
+            arr_t global;
+            if (this->distmem.rank() == 0)
+            {
+              // sent in place unless the array passed is a non-contiguous view or is not C-ordered
+              bool in_place = arr.isStorageContiguous();
+              for (int d = 0; d < n_dims; ++d)
+                in_place = in_place && arr.lbound(d) == 0 && arr.ordering(d) == n_dims - 1 - d && arr.isRankStoredAscending(d);
+              if (in_place)
+                global.reference(arr);
+              else
+              {
+                global.resize(arr.shape());
+                global = arr;
+              }
+              local = global(idx_t<n_dims>(distmem_box(this->distmem.coords)));
+            }
+            xchng_root(global, local, true);
+            advectee(e) = local;
           }
           else
 #endif
           advectee(e) = arr;
         }
 
+        // initialisation of the local part of the advectee (indexed as the global array)
+        // by each rank, without any global array
+        void advectee_local_set(const std::function<void(arr_t)> &init, int e = 0)
+        {
+          init(advectee(e));
+        }
+
         protected:
 
         rng_t distmem_ext(const rng_t &rng)
@@ -326,6 +801,13 @@ namespace libmpdataxx
           return rng_t(rng.first()-1, rng.last());
         }
 
+        // in the other dimensions, the vector at the left edge of a subdomain
+        // belongs to the process only if there is another process to the left
+        rng_t distmem_ext(const rng_t &rng, const int d)
+        {
+          return d > 0 && distmem.coords[d] == 0 ? rng : distmem_ext(rng);
+        }
+
       };
 
       template<typename real_t, int n_dims, int n_tlev>
@@ -352,41 +834,6 @@ namespace libmpdataxx
           ).reindex(this->origin);
         }
 
-        const blitz::Array<real_t, 1> advectee_global(int e = 0)
-        {
-#if defined(USE_MPI)
-          if(this->distmem.size() > 1)
-          {
-// TODO: move some of that to distmem...
-// TODO: a lot of common code betwee 1,2 and 3 dimensions...
-
-            // a vector of number of elements to be sent by each non-root process
-            std::vector<int> sizes(this->distmem.size());
-            std::iota(sizes.begin(), sizes.end(), 0); // fill with 1,2,3,...
-            for(auto &size : sizes) { size = this->slab(rng_t(0, this->distmem.grid_size[0]-1), size, this->distmem.size()).length();}
-            // calc displacement
-            std::vector<int> displ(sizes.size());
-            std::partial_sum(sizes.begin(), sizes.end(), displ.begin());
-            std::transform(displ.begin(), displ.end(), sizes.begin(), displ.begin(), std::minus<int>()); // exclusive_scan is c++17
-            // a vector that will store the received data, relevant only on process rank=0
-            std::vector<real_t> out_values(this->distmem.grid_size[0]);
-            // create an array that will store advectee to be sent in a contiguous memory block
-            std::vector<real_t> in_values_vec(advectee(e).size());
-            std::copy(advectee(e).begin(), advectee(e).end(), in_values_vec.begin());
-
-            // gather the data from all processes on rank=0
-            boost::mpi::gatherv(this->distmem.mpicom, in_values_vec, out_values.data(), sizes, displ, 0);
-            // send the result to other processes
-            boost::mpi::broadcast(this->distmem.mpicom, out_values, 0);
-
-            blitz::Array<real_t, 1> res(out_values.data(), blitz::shape(this->distmem.grid_size[0]), blitz::duplicateData);
-            return res;
-          }
-          else
-#endif
-            return advectee(e);
-        }
-
         blitz::Array<real_t, 1> advector(int d = 0)
         {
           using namespace arakawa_c;
@@ -455,47 +902,6 @@ namespace libmpdataxx
           ).reindex(this->origin);
         }
 
-        const blitz::Array<real_t, 2> advectee_global(int e = 0)
-        {
-#if defined(USE_MPI)
-          if(this->distmem.size() > 1)
-          {
-// TODO: move some of that to distmem...
-// TODO: a lot of common code betwee 1,2 and 3 dimensions...
-
-            // a vector of number of elements to be sent by each non-root process
-            std::vector<int> sizes(this->distmem.size());
-            std::iota(sizes.begin(), sizes.end(), 0); // fill with 1,2,3,...
-            for(auto &size : sizes)
-            {
-              size = this->slab(rng_t(0, this->distmem.grid_size[0]-1), size, this->distmem.size()).length()
-                      * this->grid_size[1].length();
-            }
-            // calc displacement
-            std::vector<int> displ(sizes.size());
-            std::partial_sum(sizes.begin(), sizes.end(), displ.begin());
-            std::transform(displ.begin(), displ.end(), sizes.begin(), displ.begin(), std::minus<int>()); // exclusive_scan is c++17
-            // a vector that will store the received data, relevant only on process rank=0
-            std::vector<real_t> out_values(this->distmem.grid_size[0] * this->grid_size[1].length());
-            // create an array that will store advectee to be sent in a contiguous memory block
-            std::vector<real_t> in_values_vec(advectee(e).size());
-            std::copy(advectee(e).begin(), advectee(e).end(), in_values_vec.begin());
-
-            // gather the data from all processes on rank=0
-            boost::mpi::gatherv(this->distmem.mpicom, in_values_vec, out_values.data(), sizes, displ, 0);
-            // send the result to other processes
-            boost::mpi::broadcast(this->distmem.mpicom, out_values, 0);
-
-            blitz::Array<real_t, 2> res(out_values.data(), blitz::shape(
-              this->distmem.grid_size[0], this->grid_size[1].length()),
-              blitz::duplicateData);
-            return res;
-          }
-          else
-#endif
-            return advectee(e);
-        }
-
         blitz::Array<real_t, 2> advector(int d = 0)
         {
           using namespace arakawa_c;
@@ -515,10 +921,14 @@ namespace libmpdataxx
                 this->grid_size[1]
               ).reindex(orgn);
             case 1:
+            {
+              const rng_t j_ext = this->distmem_ext(this->grid_size[1]^(-1)^h, 1);
+              orgn[1] = j_ext.first();
               return this->GC[d](
                 this->distmem_ext(this->grid_size[0]),
-                this->grid_size[1]^(-1)^h
+                j_ext
               ).reindex(orgn);
+            }
             default: assert(false); throw;
           }
         }
@@ -590,47 +1000,6 @@ namespace libmpdataxx
           ).reindex(this->origin);
         }
 
-        const blitz::Array<real_t, 3> advectee_global(int e = 0)
-        {
-#if defined(USE_MPI)
-          if(this->distmem.size() > 1)
-          {
-// TODO: move some of that to distmem...
-// TODO: a lot of common code betwee 1,2 and 3 dimensions...
-
-            // a vector of number of elements to be sent by each non-root process
-            std::vector<int> sizes(this->distmem.size());
-            std::iota(sizes.begin(), sizes.end(), 0); // fill with 1,2,3,...
-            for(auto &size : sizes)
-            {
-              size = this->slab(rng_t(0, this->distmem.grid_size[0]-1), size, this->distmem.size()).length()
-                      * this->grid_size[1].length() * this->grid_size[2].length();
-            }
-            // calc displacement
-            std::vector<int> displ(sizes.size());
-            std::partial_sum(sizes.begin(), sizes.end(), displ.begin());
-            std::transform(displ.begin(), displ.end(), sizes.begin(), displ.begin(), std::minus<int>()); // exclusive_scan is c++17
-            // a vector that will store the received data, relevant only on process rank=0
-            std::vector<real_t> out_values(this->distmem.grid_size[0] * this->grid_size[1].length() * this->grid_size[2].length());
-            // create an array that will store advectee to be sent in a contiguous memory block
-            std::vector<real_t> in_values_vec(advectee(e).size());
-            std::copy(advectee(e).begin(), advectee(e).end(), in_values_vec.begin());
-
-            // gather the data from all processes on rank=0
-            boost::mpi::gatherv(this->distmem.mpicom, in_values_vec, out_values.data(), sizes, displ, 0);
-            // send the result to other processes
-            boost::mpi::broadcast(this->distmem.mpicom, out_values, 0);
-
-            blitz::Array<real_t, 3> res(out_values.data(), blitz::shape(
-              this->distmem.grid_size[0], this->grid_size[1].length(), this->grid_size[2].length()),
-              blitz::duplicateData);
-            return res;
-          }
-          else
-#endif
-            return advectee(e);
-        }
-
         blitz::Array<real_t, 3> advector(int d = 0)
         {
           using namespace arakawa_c;
@@ -652,17 +1021,25 @@ namespace libmpdataxx
                 this->grid_size[2]
               ).reindex(orgn);
             case 1:
+            {
+              const rng_t j_ext = this->distmem_ext(this->grid_size[1]^(-1)^h, 1);
+              orgn[1] = j_ext.first();
               return this->GC[d](
                 this->distmem_ext(this->grid_size[0]),
-                this->grid_size[1]^(-1)^h,
+                j_ext,
                 this->grid_size[2]
               ).reindex(orgn);
+            }
             case 2:
+            {
+              const rng_t k_ext = this->distmem_ext(this->grid_size[2]^(-1)^h, 2);
+              orgn[2] = k_ext.first();
               return this->GC[d](
                 this->distmem_ext(this->grid_size[0]),
                 this->grid_size[1],
-                this->grid_size[2]^(-1)^h
+                k_ext
               ).reindex(orgn);
+            }
             default: assert(false); throw;
           }
         }
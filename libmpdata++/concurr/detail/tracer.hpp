@@ -0,0 +1,164 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief timeline of the solver (per-thread begin and end of advop, halo exchanges, barriers, ...)
+ *   written in the Chrome trace-event format (to be opened in Perfetto or chrome://tracing),
+ *   enabled with rt_params_t::trace_path (the timed regions being recorded only if ct_params_t::tracing is set)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // rank of the calling solver thread within its process (set at the beginning of solver_common::solve())
+      inline int &thread_rank()
+      {
+        static thread_local int rank = 0;
+        return rank;
+      }
+
+      class tracer
+      {
+        using clock_t = std::chrono::steady_clock;
+
+        struct event_t
+        {
+          const char *name, *file; // file (and line in arg) only for barriers
+          int arg;                 // e.g. equation index, -1 if none
+          clock_t::time_point t0, t1;
+        };
+
+        // one per thread, written only by its owner (hence no locking), the oldest events
+        // being overwritten if full; read after the threads are joined
+        struct ring_t
+        {
+          std::vector<event_t> events;
+          unsigned long long n = 0; // number of events recorded so far
+          char pad[64];             // avoiding false sharing of n
+        };
+
+        const std::string path;
+        const int pid;
+        std::vector<ring_t> rings;
+
+        static void escape(std::ostream &os, const char *s)
+        {
+          for (; *s != '\0'; ++s)
+          {
+            if (*s == '"' || *s == '\\') os << '\\';
+            os << *s;
+          }
+        }
+
+        // timestamps from the steady clock epoch (common to the processes on a node)
+        static double us(const clock_t::time_point &t)
+        {
+          return std::chrono::duration<double, std::micro>(t.time_since_epoch()).count();
+        }
+
+        public:
+
+        // a timed event from construction to destruction, nothing is done if trc == nullptr
+        class scope
+        {
+          tracer *trc;
+          const char *name;
+          int arg;
+          clock_t::time_point t0;
+
+          public:
+
+          scope(tracer *trc, const char *name, const int arg = -1) : trc(trc), name(name), arg(arg)
+          {
+            if (trc != nullptr) t0 = clock_t::now();
+          }
+
+          scope(const scope &) = delete;
+          scope(scope &&o) : trc(o.trc), name(o.name), arg(o.arg), t0(o.t0)
+          {
+            o.trc = nullptr;
+          }
+
+          ~scope()
+          {
+            if (trc != nullptr) trc->record(name, t0, clock_t::now(), arg);
+          }
+        };
+
+        // one ring buffer per solver thread, with capacity for n_events events each;
+        // with MPI, each process writes its own file (rank appended to path if size > 1)
+        tracer(const std::string &path, const int n_thrds, const int rank, const int size, const std::size_t n_events = 1 << 16) :
+          path(size > 1 ? path + "." + std::to_string(rank) : path),
+          pid(rank),
+          rings(n_thrds)
+        {
+          for (auto &r : rings) r.events.resize(n_events);
+        }
+
+        void record(
+          const char *name,
+          const clock_t::time_point &t0,
+          const clock_t::time_point &t1,
+          const int arg = -1,
+          const char *file = nullptr
+        )
+        {
+          auto &r = rings[thread_rank()];
+          r.events[r.n++ % r.events.size()] = {name, file, arg, t0, t1};
+        }
+
+        // writing the file
+        ~tracer()
+        {
+          std::ofstream os(path);
+          if (!os)
+          {
+            std::cerr << "tracer: cannot open " << path << std::endl;
+            return;
+          }
+          os.precision(3);
+          os << std::fixed << "{\"traceEvents\":[" << std::endl;
+          bool first = true;
+          for (int t = 0; t < int(rings.size()); ++t)
+          {
+            const auto &r = rings[t];
+            os << (first ? "" : ",\n")
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << t
+               << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+            first = false;
+            const unsigned long long size = r.events.size(), beg = r.n > size ? r.n - size : 0;
+            if (beg > 0)
+              std::cerr << "tracer: " << beg << " oldest events of thread " << t << " dropped (ring buffer full)" << std::endl;
+            for (auto i = beg; i < r.n; ++i)
+            {
+              const auto &e = r.events[i % size];
+              os << ",\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << t
+                 << ",\"ts\":" << us(e.t0) << ",\"dur\":" << std::chrono::duration<double, std::micro>(e.t1 - e.t0).count();
+              if (e.file != nullptr)
+              {
+                os << ",\"args\":{\"site\":\"";
+                escape(os, e.file);
+                os << ":" << e.arg << "\"}";
+              }
+              else if (e.arg != -1) os << ",\"args\":{\"arg\":" << e.arg << "}";
+              os << "}";
+            }
+          }
+          os << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
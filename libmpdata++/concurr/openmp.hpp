@@ -51,14 +51,14 @@ namespace libmpdataxx
 #endif
         }
 
-        void barrier()
+        void barrier_impl()
         {
           // TODO: if (size() != 1) ???
 #pragma omp barrier
         }
 
         // ctors
-        mem_t(const std::array<int, solver_t::n_dims> &grid_size) : parent_t::mem_t(grid_size, size(grid_size[0])) {};
+        mem_t(const std::array<int, solver_t::n_dims> &grid_size, const std::array<int, solver_t::n_dims> &mpi_dims, const bool mpi_comm_thread) : parent_t::mem_t(grid_size, size(grid_size[0]), mpi_dims, mpi_comm_thread) {};
       };
 
       void solve(typename parent_t::advance_arg_t nt)
@@ -77,7 +77,7 @@ namespace libmpdataxx
 
       // ctor
       openmp(const typename solver_t::rt_params_t &p) :
-        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size[0]))
+        parent_t(p, new mem_t(p.grid_size, p.mpi_dims, p.mpi_comm_thread), mem_t::size(p.grid_size[0]))
       {}
 
     };
@@ -30,11 +30,11 @@ namespace libmpdataxx
       {
         static int size() { return 1; }
 
-        void barrier() { }
+        void barrier_impl() { }
 
         // ctors
-        mem_t(const std::array<int, solver_t::n_dims> &grid_size)
-          : parent_t::mem_t(grid_size, size())
+        mem_t(const std::array<int, solver_t::n_dims> &grid_size, const std::array<int, solver_t::n_dims> &mpi_dims, const bool mpi_comm_thread)
+          : parent_t::mem_t(grid_size, size(), mpi_dims, mpi_comm_thread)
         {};
       };
 
@@ -47,7 +47,7 @@ namespace libmpdataxx
 
       // ctor
       serial(const typename solver_t::rt_params_t &p) :
-        parent_t(p, new mem_t(p.grid_size), mem_t::size())
+        parent_t(p, new mem_t(p.grid_size, p.mpi_dims, p.mpi_comm_thread), mem_t::size())
       {}
 
     };
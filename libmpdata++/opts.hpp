@@ -89,6 +89,7 @@ namespace libmpdataxx
     enum { vip_vab = 0};
     enum { prs_k_iters = 4};
     enum { prs_khn = false}; // if true use Kahan summation in the pressure solver
+    enum { prs_repro = false}; // if true use sums bitwise independent of the numbers of threads and processes in the pressure solver
     enum { sgs_scheme = 0}; // iles
     enum { stress_diff = 0};
     enum { impl_tht = false};
@@ -97,5 +98,7 @@ namespace libmpdataxx
     enum { out_intrp_ord = 1};  // order of temporal interpolation for output
                                 // order > 1 is mostly useful for convergence tests as it can result
                                 // in negative field values
+    enum { phase_timers = false}; // if true time the phases of the solver (see concurr::any::phase_timings)
+    enum { tracing = false}; // if true the timeline of the run can be written (see rt_params_t::trace_path)
   };
 } // namespace libmpdataxx
@@ -8,13 +8,19 @@
 #pragma once
 
 #include <map>
+#include <array>
 #include <vector>
 #include <functional>
+#include <string>
+#include <stdexcept>
 
 namespace libmpdataxx
 {
   namespace output
   {
+    // kinds of in-situ horizontal statistics (vertical profiles, i.e. one value per level)
+    enum stat_e { stat_mean, stat_var, stat_cov, stat_min, stat_max };
+
     namespace detail
     {
       template <class solver_t>
@@ -24,9 +30,26 @@ namespace libmpdataxx
 
         protected:
 
-        struct info_t { std::string name, unit; };
+        struct info_t
+        {
+          std::string name, unit;
+          // lossy output options (currently handled by hdf5 output only):
+          int keepbits = 0;    // if > 0, mantissa bits kept after rounding (bit-rounding before compression)
+          bool pack16 = false; // if true, stored as 16-bit integers with scale_factor, add_offset and _FillValue (non-finite values) attributes, excludes keepbits
+          // output region (hyperslab) in each dimension, zero count means up to the domain end, zero stride means 1
+          std::array<int, parent_t::n_dims> start = {}, count = {}, stride = {};
+        };
         std::map<int, info_t> outvars;
 
+        struct stat_t
+        {
+          std::string name; // name of the output profile
+          stat_e type;
+          int var, var2 = -1; // var2 used for covariances only
+        };
+        std::vector<stat_t> outstats;
+        const int statfreq;
+
         int do_record_cnt = 0;
         typename parent_t::real_t record_time;
         const typename parent_t::advance_arg_t outfreq;
@@ -39,6 +62,86 @@ namespace libmpdataxx
         virtual void record(const int var) {}
         virtual void start(const typename parent_t::advance_arg_t nt) {}
 
+        // called by all threads before record_all(), intended for preparing output data in parallel
+        virtual void record_prep() {}
+
+        // called by the master thread with profiles of all outstats (in the same order)
+        virtual void record_stats(const std::vector<std::vector<double>> &profs) {}
+
+        // computation of the outstats profiles, called by all threads
+        void calc_stats()
+        {
+          if (outstats.empty() || this->timestep % statfreq != 0) return;
+
+          using slice_t = idx_t<parent_t::n_dims>;
+          using mem_t = typename parent_t::mem_t;
+
+          // number of points on each level (of the whole domain)
+          double nh = 1;
+          for (int d = 0; d < parent_t::n_dims - 1; ++d)
+            nh *= this->mem->distmem.grid_size[d];
+
+          std::vector<std::vector<double>> profs;
+          for (const auto &s : outstats)
+          {
+            const auto psi1 = this->mem->advectee(s.var);
+
+            auto mean = [&](const typename parent_t::arr_t &psi)
+            {
+              auto prof = this->mem->prof_reduce(this->rank, this->ijk,
+                [&](const slice_t &idx, const int) { return blitz::sum(psi(idx)); },
+                mem_t::prof_sum
+              );
+              for (auto &v : prof) v /= nh;
+              return prof;
+            };
+
+            switch (s.type)
+            {
+              case stat_mean:
+                profs.push_back(mean(psi1));
+                break;
+              case stat_var:
+              {
+                // two-pass algorithm, deviations from the level mean are summed
+                const auto m1 = mean(psi1);
+                profs.push_back(this->mem->prof_reduce(this->rank, this->ijk,
+                  [&](const slice_t &idx, const int k) { return blitz::sum(pow2(psi1(idx) - m1[k])); },
+                  mem_t::prof_sum
+                ));
+                for (auto &v : profs.back()) v /= nh;
+                break;
+              }
+              case stat_cov:
+              {
+                const auto psi2 = this->mem->advectee(s.var2);
+                const auto m1 = mean(psi1), m2 = mean(psi2);
+                profs.push_back(this->mem->prof_reduce(this->rank, this->ijk,
+                  [&](const slice_t &idx, const int k) { return blitz::sum((psi1(idx) - m1[k]) * (psi2(idx) - m2[k])); },
+                  mem_t::prof_sum
+                ));
+                for (auto &v : profs.back()) v /= nh;
+                break;
+              }
+              case stat_min:
+                profs.push_back(this->mem->prof_reduce(this->rank, this->ijk,
+                  [&](const slice_t &idx, const int) { return blitz::min(psi1(idx)); },
+                  mem_t::prof_min
+                ));
+                break;
+              case stat_max:
+                profs.push_back(this->mem->prof_reduce(this->rank, this->ijk,
+                  [&](const slice_t &idx, const int) { return blitz::max(psi1(idx)); },
+                  mem_t::prof_max
+                ));
+                break;
+            }
+          }
+
+          if (this->rank == 0) record_stats(profs);
+          this->mem->barrier();
+        }
+
         typename parent_t::arr_t out_data(const int var)
         {
           return this->var_dt ? intrp_vars[var] : this->mem->advectee(var);
@@ -59,9 +162,29 @@ namespace libmpdataxx
           {
             record_time = this->time;
             start(nt);
+          }
+          this->mem->barrier();
+
+          record_prep();
+          this->mem->barrier();
+
+          if (this->rank == 0)
+          {
+            const auto region = this->timed_region("record_all");
             record_all();
           }
           this->mem->barrier();
+
+          calc_stats();
+        }
+
+        // output continued after restart from a checkpoint: files are set up, but no initial record is done
+        void hook_ante_restart(const typename parent_t::advance_arg_t nt)
+        {
+          parent_t::hook_ante_restart(nt);
+
+          if (this->rank == 0) start(nt);
+          this->mem->barrier();
         }
 
         virtual void record_all()
@@ -145,25 +268,39 @@ namespace libmpdataxx
               this->mem->barrier();
           }
 
-          if (this->rank == 0)
+          // number of records to be done in this timestep (known to all threads)
+          int n_records = 0;
+          if (this->var_dt)
           {
-            //TODO: output of solver statistics every timesteps could probably go here
-
-            if (this->var_dt && do_record_cnt == 1)
+            if (do_record_cnt == 1) n_records = 1;
+          }
+          else
+          {
+            for (int t = 0; t < outwindow; ++t)
             {
-              record_all();
+              if ((this->timestep - t) % static_cast<int>(outfreq) == 0) ++n_records;
             }
-            else if (!this->var_dt)
+          }
+
+          if (n_records > 0)
+          {
+            record_prep();
+            this->mem->barrier();
+          }
+
+          if (this->rank == 0)
+          {
+            if (!this->var_dt) record_time = this->time;
+            for (int r = 0; r < n_records; ++r)
             {
-              record_time = this->time;
-              for (int t = 0; t < outwindow; ++t)
-              {
-                if ((this->timestep - t) % static_cast<int>(outfreq) == 0) record_all();
-              }
+              const auto region = this->timed_region("record_all");
+              record_all();
             }
           }
 
           this->mem->barrier(); // waiting for the output to be finished
+
+          calc_stats();
         }
 
         public:
@@ -173,6 +310,8 @@ namespace libmpdataxx
           typename parent_t::advance_arg_t outfreq = 1;
           int outwindow = 1;
           std::map<int, info_t> outvars;
+          std::vector<stat_t> outstats; // horizontal statistics (currently recorded by hdf5 output only)
+          int statfreq = 1;             // outstats computed every statfreq timesteps
           std::string outdir;
           // TODO: pass adiitional info? (command_line, library versions, ...)
         };
@@ -186,6 +325,8 @@ namespace libmpdataxx
           outfreq(p.outfreq),
           outwindow(p.outwindow),
           outvars(p.outvars),
+          outstats(p.outstats),
+          statfreq(p.statfreq),
           outdir(p.outdir),
           intrp_vars(args.mem->tmp[__FILE__][0])
         {
@@ -193,6 +334,14 @@ namespace libmpdataxx
           if (this->outvars.size() == 0 && parent_t::n_eqns == 1)
             outvars = {{0, {"", ""}}};
 
+          if (!outstats.empty() && parent_t::n_dims == 1)
+            throw std::runtime_error("horizontal statistics output (outstats) requires a 2D or 3D domain");
+          if (statfreq <= 0)
+            throw std::runtime_error("statfreq has to be positive");
+          for (const auto &s : outstats)
+            if (s.type == stat_cov && s.var2 < 0)
+              throw std::runtime_error("covariance statistics require var2 to be set");
+
 
           // assign 1 to dt, di, dj, dk for output purposes if they are not defined by the user
           for (auto ref :
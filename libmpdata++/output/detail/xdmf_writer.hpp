@@ -6,6 +6,9 @@
 #include <set>
 #include <string>
 #include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
 
 #include <boost/version.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -30,7 +33,8 @@ namespace libmpdataxx
         struct data_item
         {
           blitz::TinyVector<int, dim> dimensions;
-          const std::string number_type = "Float";
+          std::string number_type = "Float";
+          int precision = 4;
           const std::string format = "HDF";
           std::string data;
           void add(ptree& node)
@@ -41,6 +45,7 @@ namespace libmpdataxx
             ptree& dat_node = node.add("DataItem", data);
             dat_node.put("<xmlattr>.Dimensions", ss.str());
             dat_node.put("<xmlattr>.NumberType", number_type);
+            if (number_type != "Float") dat_node.put("<xmlattr>.Precision", precision);
             dat_node.put("<xmlattr>.Format", format);
           }
         };
@@ -101,6 +106,45 @@ namespace libmpdataxx
         std::set<attribute> attrs;
         std::set<attribute> c_attrs;
 
+        // per-timestep markup rendered once (with placeholders for the hdf file name and time)
+        // and re-rendered only if the set of attributes changes
+        const std::string hdf_tag = "@HDF@", time_tag = "@TIME@";
+        std::string tmpl;
+
+        // temporal collection files already started by this writer (later only appended to)
+        std::set<std::string> temporal_started;
+        const std::string temporal_footer = "\t\t</Grid>\n\t</Domain>\n</Xdmf>\n";
+
+        void render_tmpl()
+        {
+          for (auto& a : attrs)
+          {
+            a.item.data = hdf_tag + ":/" + a.name;
+          }
+
+          ptree pt;
+          ptree& grid_node = pt.put("Xdmf.Domain.Grid", "");
+          grid_node.put("<xmlattr>.Name", name);
+          grid_node.put("<xmlattr>.GridType", grid_type);
+          grid_node.put("<xmlattr>.xml:id", "gid");
+          grid_node.put("Time.<xmlattr>.Value", time_tag);
+
+          top.add(grid_node);
+
+          geo.add(grid_node);
+
+          for (auto a : attrs)
+            a.add(grid_node);
+
+          for (auto ca : c_attrs)
+            ca.add(grid_node);
+
+          std::ostringstream ss;
+          xml_writer_settings settings('\t', 1);
+          write_xml(ss, pt, settings);
+          tmpl = ss.str();
+        }
+
         attribute make_attribute(const std::string& name,
                                  const blitz::TinyVector<int, dim>& dimensions)
         {
@@ -117,6 +161,7 @@ namespace libmpdataxx
                    const std::vector<std::string>& attr_names,
                    const blitz::TinyVector<int, dim>& dimensions)
         {
+          tmpl.clear();
           top.dimensions = dimensions + 1;
 
           for (const auto& dn : dim_names)
@@ -132,13 +177,27 @@ namespace libmpdataxx
         }
 
 
+        // e.g. for attributes stored as packed integers
+        void set_number_type(const std::string& name,
+                             const std::string& number_type,
+                             const int precision)
+        {
+          tmpl.clear();
+          for (auto& a : attrs)
+          {
+            if (a.name != name) continue;
+            a.item.number_type = number_type;
+            a.item.precision = precision;
+          }
+        }
+
         void add_attribute(const std::string& name,
                                  const std::string& hdf_name,
                                  const blitz::TinyVector<int, dim>& dimensions)
         {
           attribute a = make_attribute(name, dimensions);
           a.item.data = hdf_name + ":/" + a.name;
-          attrs.insert(a);
+          if (attrs.insert(a).second) tmpl.clear();
         }
 
         void add_const_attribute(const std::string& name,
@@ -148,59 +207,76 @@ namespace libmpdataxx
           // there is one more coordinate than cell index in each dimension
           attribute a = make_attribute(name, dimensions + 1);
           a.item.data = hdf_name + ":/" + a.name;
-          c_attrs.insert(a);
+          if (c_attrs.insert(a).second) tmpl.clear();
         }
 
         void write(const std::string& xmf_name, const std::string& hdf_name, const double time)
         {
-          for (auto& a : attrs)
+          if (tmpl.empty()) render_tmpl();
+
+          std::string xml;
+          xml.reserve(tmpl.size() + attrs.size() * hdf_name.size());
+          const std::string time_str = std::to_string(time);
+          for (std::size_t pos = 0;;)
           {
-            a.item.data = hdf_name + ":/" + a.name;
+            const std::size_t
+              h = tmpl.find(hdf_tag, pos),
+              t = tmpl.find(time_tag, pos),
+              nxt = std::min(h, t);
+            xml.append(tmpl, pos, nxt == std::string::npos ? std::string::npos : nxt - pos);
+            if (nxt == std::string::npos) break;
+            xml.append(nxt == h ? hdf_name : time_str);
+            pos = nxt + (nxt == h ? hdf_tag : time_tag).size();
           }
 
-          ptree pt;
-          ptree& grid_node = pt.put("Xdmf.Domain.Grid", "");
-          grid_node.put("<xmlattr>.Name", name);
-          grid_node.put("<xmlattr>.GridType", grid_type);
-          grid_node.put("<xmlattr>.xml:id", "gid");
-          grid_node.put("Time.<xmlattr>.Value", std::to_string(time));
-
-          top.add(grid_node);
-
-          geo.add(grid_node);
-
-          for (auto a : attrs)
-            a.add(grid_node);
-
-          for (auto ca : c_attrs)
-            ca.add(grid_node);
-
-          xml_writer_settings settings('\t', 1);
-          write_xml(xmf_name, pt, std::locale(), settings);
+          std::ofstream ofs(xmf_name, std::ios::trunc);
+          ofs << xml;
+          if (!ofs) throw std::runtime_error("error writing " + xmf_name);
         }
 
-        void write_temporal(const std::string& xmf_name, const std::vector<std::string>& timesteps)
+        // appends a timestep to the temporal collection, the file is created on first call,
+        // and then only its closing tags are overwritten (instead of rewriting the whole collection);
+        // on a run resumed from a checkpoint the entries written before are kept, except those
+        // not preceding the current timestep (written by the interrupted run after the checkpoint)
+        void write_temporal(const std::string& xmf_name, const std::string& timestep, const bool resume = false)
         {
+          const std::string
+            prefix = "\t\t\t<xi:include href=\"",
+            entry = prefix + timestep + "\" xpointer=\"gid\"/>\n";
 
-          ptree pt;
-          ptree& xdmf_node = pt.put("Xdmf", "");
-          xdmf_node.put("<xmlattr>.xmlns:xi", "http://www.w3.org/2001/XInclude");
-          ptree& grid_node = xdmf_node.put("Domain.Grid", "");
-          grid_node.put("<xmlattr>.Name", "TimeGrid");
-          grid_node.put("<xmlattr>.GridType", "Collection");
-          grid_node.put("<xmlattr>.CollectionType", "Temporal");
-
-          for (auto ts : timesteps)
+          if (temporal_started.insert(xmf_name).second)
           {
-            ptree& ts_node = grid_node.add("xi:include", "");
-            ts_node.put("<xmlattr>.href", ts);
-            ts_node.put("<xmlattr>.xpointer", "gid");
-          }
+            std::string entries;
+            if (resume)
+            {
+              // timestep file names are zero-padded, hence ordered as strings
+              std::ifstream ifs(xmf_name);
+              for (std::string line; std::getline(ifs, line);)
+              {
+                if (line.compare(0, prefix.size(), prefix) != 0) continue;
+                if (line.substr(prefix.size(), line.find('"', prefix.size()) - prefix.size()) < timestep)
+                  entries += line + "\n";
+              }
+            }
 
-          xml_writer_settings settings('\t', 1);
-          write_xml(xmf_name, pt, std::locale(), settings);
+            std::ofstream ofs(xmf_name, std::ios::trunc);
+            ofs << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                << "<Xdmf xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+                << "\t<Domain>\n"
+                << "\t\t<Grid Name=\"TimeGrid\" GridType=\"Collection\" CollectionType=\"Temporal\">\n"
+                << entries
+                << entry
+                << temporal_footer;
+            if (!ofs) throw std::runtime_error("error writing " + xmf_name);
+          }
+          else
+          {
+            std::fstream fs(xmf_name, std::ios::in | std::ios::out);
+            fs.seekp(-static_cast<std::streamoff>(temporal_footer.size()), std::ios::end);
+            fs << entry << temporal_footer;
+            if (!fs) throw std::runtime_error("error appending to " + xmf_name);
+          }
         }
-
       };
 
     }
@@ -23,13 +23,23 @@
 #endif
 
 #include <vector>
+#include <set>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
 namespace libmpdataxx
 {
   namespace output
   {
+    // compression filters that can be applied to the output datasets
+    // (lz4 and zstd are HDF5 plugins, they have to be registered e.g. through HDF5_PLUGIN_PATH)
+    enum class hdf5_filter_e { none, deflate, lz4, zstd };
+
     template <class solver_t>
     class hdf5 : public detail::output_common<solver_t>
     {
@@ -59,6 +69,33 @@ namespace libmpdataxx
       H5::DSetCreatPropList params;
 
       H5::DataSpace sspace, cspace, srfcspace;
+
+      // user-requested chunking and compression settings
+      const std::array<int, parent_t::n_dims> chunk_req;
+      const hdf5_filter_e filter;
+      const int filter_level;
+      const bool shuffle;
+
+      // output region of a variable (see info_t::start, count and stride)
+      struct sel_t
+      {
+        bool full = true;  // whole domain at full resolution
+        std::string name;  // suffix of region coordinates names, common for variables with the same region
+        std::array<int, parent_t::n_dims> start, count, stride;
+        blitz::TinyVector<hsize_t, parent_t::n_dims> gshape, shape, offst; // global and local (MPI) shapes, local offset
+        std::array<rng_t, parent_t::n_dims> rng; // local part of the region in domain indices (valid if shape != 0)
+        typename solver_t::arr_t *buf = nullptr; // contiguous buffer filled in parallel in record_prep()
+        H5::DSetCreatPropList params;
+      };
+      std::map<int, sel_t> sel;
+
+      // horizontal statistics file (see output_common::outstats), kept open during the simulation
+      std::unique_ptr<H5::H5File> stats_hdfp;
+      hsize_t stats_cnt = 0;
+
+      // set on restart from a checkpoint, output files are then continued (if possible)
+      bool resume = false;
+
 #if defined(USE_MPI)
       hid_t fapl_id;
 #endif
@@ -112,22 +149,30 @@ namespace libmpdataxx
           cspace = H5::DataSpace(parent_t::n_dims, cshape.data());
 
 #if defined(USE_MPI)
-          if (this->mem->distmem.size() > 1)
+          // local part of the domain in each dimension divided among processes
+          for (int d = 0; d < parent_t::n_dims; ++d)
           {
-            shape[0] = this->mem->grid_size[0].length();
-            cshape[0] = this->mem->grid_size[0].length();
+            if (this->mem->distmem.dims[d] == 1) continue;
+
+            shape[d] = this->mem->grid_size[d].length();
+            cshape[d] = this->mem->grid_size[d].length();
 
-            if (this->mem->distmem.rank() == this->mem->distmem.size() - 1)
-              cshape[0] += 1;
+            if (this->mem->distmem.coords[d] == this->mem->distmem.dims[d] - 1)
+              cshape[d] += 1;
 
-            offst[0] = this->mem->grid_size[0].first();
+            offst[d] = this->mem->grid_size[d].first();
 
             // chunk size has to be common to all processes !
             // TODO: something better ?
-            chunk[0] = ( (typename solver_t::real_t) (this->mem->distmem.grid_size[0])) / this->mem->distmem.size() + 0.5 ;
+            chunk[d] = ( (typename solver_t::real_t) (this->mem->distmem.grid_size[d])) / this->mem->distmem.dims[d] + 0.5 ;
           }
 #endif
 
+          // user-defined chunk shape (zero means the default, i.e. the whole local domain)
+          for (int d = 0; d < parent_t::n_dims; ++d)
+            if (chunk_req[d] > 0)
+              chunk[d] = std::min(hsize_t(chunk_req[d]), hsize_t(this->mem->distmem.grid_size[d]));
+
           srfcshape = shape;
           *(srfcshape.end()-1) = 1;
 
@@ -135,9 +180,7 @@ namespace libmpdataxx
           *(srfcchunk.end()-1) = 1;
 
           params.setChunk(parent_t::n_dims, chunk.data());
-#if !defined(USE_MPI)
-          params.setDeflate(5); // TODO: move such constant to the header
-#endif
+          set_filters();
 
           // creating variables
           {
@@ -174,6 +217,46 @@ namespace libmpdataxx
               curr_dim.write(coord.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, cshape.data()), dim_space, dxpl_id);
             }
 
+            // coordinates of cell edges of the output regions (written by the first process only)
+            std::set<std::string> roi_done;
+            for (auto &vs : sel)
+            {
+              auto &s = vs.second;
+              if (s.full) continue;
+
+              // chunk cannot exceed the dataset shape
+              s.params = H5::DSetCreatPropList(H5Pcopy(params.getId()));
+              blitz::TinyVector<hsize_t, parent_t::n_dims> roi_chunk;
+              for (int d = 0; d < parent_t::n_dims; ++d)
+                roi_chunk[d] = std::min(chunk[d], s.gshape[d]);
+              s.params.setChunk(parent_t::n_dims, roi_chunk.data());
+
+              if (!roi_done.insert(s.name).second) continue;
+
+              const blitz::TinyVector<hsize_t, parent_t::n_dims> roi_cshape = s.gshape + 1;
+              for (int i = 0; i < parent_t::n_dims; ++i)
+              {
+                auto curr_dim = (*hdfp).createDataSet(dim_names[i] + "_" + s.name, flttype_output, H5::DataSpace(parent_t::n_dims, roi_cshape.data()));
+
+                if (this->mem->distmem.rank() != 0) continue;
+
+                // edges of the (coarse) cells, the last one not exceeding the domain
+                const int st = s.start[i], sr = s.stride[i], nn = this->mem->distmem.grid_size[i];
+                blitz::Array<typename solver_t::real_t, parent_t::n_dims> coord(roi_cshape);
+                switch (i)
+                {
+                  case 0 : coord = this->di * where(st + sr * blitz::firstIndex() > nn, nn, st + sr * blitz::firstIndex());
+                           break;
+                  case 1 : coord = this->dj * where(st + sr * blitz::secondIndex() > nn, nn, st + sr * blitz::secondIndex());
+                           break;
+                  case 2 : coord = this->dk * where(st + sr * blitz::thirdIndex() > nn, nn, st + sr * blitz::thirdIndex());
+                           break;
+                  default : break;
+                }
+                curr_dim.write(coord.data(), flttype_solver);
+              }
+            }
+
             // T
             {
               const hsize_t
@@ -201,6 +284,264 @@ namespace libmpdataxx
             record_params(*hdfp, typename parent_t::solver_family{});
           }
         }
+
+        if (!this->outstats.empty() && resume && boost::filesystem::exists(this->outdir + "/stats.h5"))
+        {
+          // continuing the statistics from before the checkpoint, later records (if any) get overwritten
+          stats_hdfp.reset(new H5::H5File(this->outdir + "/stats.h5", H5F_ACC_RDWR
+#if defined(USE_MPI)
+            , H5P_DEFAULT, fapl_id
+#endif
+          ));
+          H5::DataSet tset = stats_hdfp->openDataSet("T");
+          hsize_t nrec;
+          tset.getSpace().getSimpleExtentDims(&nrec);
+          std::vector<typename solver_t::real_t> tvals(nrec);
+          tset.read(tvals.data(), flttype_solver, H5::DataSpace(1, &nrec), tset.getSpace(), dxpl_id);
+          stats_cnt = std::count_if(tvals.begin(), tvals.end(), [&](const typename solver_t::real_t t) { return t <= this->time; });
+        }
+        else if (!this->outstats.empty())
+        {
+          // creating the statistics file with time x level datasets extended with each record
+          stats_hdfp.reset(new H5::H5File(this->outdir + "/stats.h5", H5F_ACC_TRUNC
+#if defined(USE_MPI)
+            , H5P_DEFAULT, fapl_id
+#endif
+          ));
+
+          const hsize_t nz = this->mem->distmem.grid_size[parent_t::n_dims - 1];
+          const hsize_t
+            dims[2] = {0, nz},
+            maxdims[2] = {H5S_UNLIMITED, nz},
+            chnk[2] = {16, nz};
+          H5::DSetCreatPropList stats_params;
+          stats_params.setChunk(2, chnk);
+
+          for (const auto &st : this->outstats)
+            stats_hdfp->createDataSet(st.name, H5::PredType::NATIVE_DOUBLE, H5::DataSpace(2, dims, maxdims), stats_params);
+
+          stats_params.setChunk(1, chnk);
+          stats_hdfp->createDataSet("T", flttype_output, H5::DataSpace(1, dims, maxdims), stats_params);
+        }
+      }
+
+      // appending a row (or a single value if n == 1) to a time-extendible dataset of the stats file,
+      // data are the same on all processes, only the first one writes them
+      void record_stats_hlpr(const std::string &name, const void *data, const H5::DataType &type, const hsize_t n, const int ndims)
+      {
+        H5::DataSet dset = stats_hdfp->openDataSet(name);
+        const hsize_t
+          ext[2] = {stats_cnt, n},
+          cnt[2] = {1, n},
+          off[2] = {stats_cnt - 1, 0};
+        dset.extend(ext);
+        H5::DataSpace space = dset.getSpace(), mspace(ndims, cnt + 2 - ndims);
+        if (this->mem->distmem.rank() == 0)
+          space.selectHyperslab(H5S_SELECT_SET, cnt + 2 - ndims, off);
+        else
+        {
+          space.selectNone();
+          mspace.selectNone();
+        }
+        dset.write(data, type, mspace, space, dxpl_id);
+      }
+
+      // shared arrays making up the solver state
+      std::map<std::string, typename solver_t::arr_t*> ckpt_arrays()
+      {
+        std::map<std::string, typename solver_t::arr_t*> res;
+        for (int e = 0; e < parent_t::n_eqns; ++e)
+          for (int t = 0; t < solver_t::n_tlev; ++t)
+            res["psi_" + std::to_string(e) + "_" + std::to_string(t)] = &this->mem->psi[e][t];
+
+        const std::map<std::string, arrvec_t<typename solver_t::arr_t>*> vecs{
+          {"GC", &this->mem->GC},
+          {"ndt_GC", &this->mem->ndt_GC},
+          {"ndtt_GC", &this->mem->ndtt_GC},
+          {"khn_tmp", &this->mem->khn_tmp},
+          {"vab_relax", &this->mem->vab_relax}
+        };
+        for (const auto &v : vecs)
+          for (int i = 0; i < v.second->size(); ++i)
+            res[v.first + "_" + std::to_string(i)] = &(*v.second)[i];
+
+        // fields set by the user before the run
+        if (this->mem->G) res["G"] = this->mem->G.get();
+        if (this->mem->vab_coeff) res["vab_coeff"] = this->mem->vab_coeff.get();
+
+        for (const auto &ct : this->mem->ckpt_tmp)
+        {
+          auto &av = this->mem->tmp.at(ct.second.first)[ct.second.second];
+          for (int i = 0; i < av.size(); ++i)
+            res[ct.first + "_" + std::to_string(i)] = &av[i];
+        }
+        return res;
+      }
+
+      // writing or reading an array (with halos) as a part of a global dataset,
+      // with MPI, each process writes its part of the domain (and the outer halos if on the edge)
+      // and reads its part together with the halos (overlapping with neighbours)
+      void ckpt_hlpr(H5::H5File &file, const std::string &name, typename solver_t::arr_t &arr, const bool write)
+      {
+        assert(arr.isStorageContiguous());
+
+        hsize_t gshape[parent_t::n_dims], lshape[parent_t::n_dims], cnt[parent_t::n_dims], moff[parent_t::n_dims], foff[parent_t::n_dims];
+        for (int d = 0; d < parent_t::n_dims; ++d)
+        {
+          const rng_t &gs = this->mem->grid_size[d];
+          const int
+            nn = this->mem->distmem.grid_size[d],
+            hl = gs.first() - arr.lbound(d),
+            hr = arr.ubound(d) - gs.last(),
+            lo = !write || gs.first() == 0      ? arr.lbound(d) : gs.first(),
+            hi = !write || gs.last()  == nn - 1 ? arr.ubound(d) : gs.last();
+
+          lshape[d] = arr.extent(d);
+          gshape[d] = hl + nn + hr;
+          cnt[d] = hi - lo + 1;
+          moff[d] = lo - arr.lbound(d);
+          foff[d] = lo + hl;
+        }
+
+        H5::DataSet dset;
+        if (write)
+          dset = file.createDataSet(name, flttype_solver, H5::DataSpace(parent_t::n_dims, gshape));
+        else
+        {
+          dset = file.openDataSet(name);
+          hsize_t fshape[parent_t::n_dims];
+          if (dset.getSpace().getSimpleExtentNdims() != parent_t::n_dims)
+            throw std::runtime_error("checkpoint incompatible with the solver: " + name);
+          dset.getSpace().getSimpleExtentDims(fshape);
+          for (int d = 0; d < parent_t::n_dims; ++d)
+            if (fshape[d] != gshape[d])
+              throw std::runtime_error("checkpoint incompatible with the solver: " + name);
+        }
+
+        H5::DataSpace fspace = dset.getSpace(), mspace(parent_t::n_dims, lshape);
+        fspace.selectHyperslab(H5S_SELECT_SET, cnt, foff);
+        mspace.selectHyperslab(H5S_SELECT_SET, cnt, moff);
+        if (write)
+          dset.write(arr.dataFirst(), flttype_solver, mspace, fspace, dxpl_id);
+        else
+          dset.read(arr.dataFirst(), flttype_solver, mspace, fspace, dxpl_id);
+      }
+
+      template <typename T>
+      void ckpt_attr(H5::H5File &file, const std::string &name, T *data, const hsize_t n, const H5::DataType &type, const bool write)
+      {
+        if (write)
+          file.createAttribute(name, type, H5::DataSpace(1, &n)).write(type, data);
+        else
+        {
+          H5::Attribute attr = file.openAttribute(name);
+          hsize_t fn;
+          attr.getSpace().getSimpleExtentDims(&fn);
+          if (fn != n) throw std::runtime_error("checkpoint incompatible with the solver: " + name);
+          attr.read(type, data);
+        }
+      }
+
+      void ckpt_io(const std::string &path, const bool write)
+      {
+#if defined(USE_MPI)
+        H5Pset_fapl_mpio(fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+        H5Pset_dxpl_mpio(dxpl_id, H5FD_MPIO_COLLECTIVE);
+#endif
+        H5::H5File file(path, write ? H5F_ACC_TRUNC : H5F_ACC_RDONLY
+#if defined(USE_MPI)
+          , H5P_DEFAULT, fapl_id
+#endif
+        );
+
+        // sanity checks
+        std::array<int, parent_t::n_dims> grid_size = this->mem->distmem.grid_size;
+        int real_size = sizeof(typename solver_t::real_t);
+        ckpt_attr(file, "grid_size", grid_size.data(), parent_t::n_dims, H5::PredType::NATIVE_INT, write);
+        ckpt_attr(file, "real_size", &real_size, 1, H5::PredType::NATIVE_INT, write);
+        if (grid_size != this->mem->distmem.grid_size || real_size != sizeof(typename solver_t::real_t))
+          throw std::runtime_error("checkpoint " + path + " was written for a different grid or floating point type");
+
+        // the clock (common for all threads)
+        ckpt_attr(file, "timestep", &this->timestep, 1, H5::PredType::NATIVE_LLONG, write);
+        ckpt_attr(file, "time", &this->time, 1, flttype_solver, write);
+        ckpt_attr(file, "dt", &this->dt, 1, flttype_solver, write);
+        ckpt_attr(file, "dt_stash", this->dt_stash.data(), this->dt_stash.size(), flttype_solver, write);
+        ckpt_attr(file, "n", this->n.data(), this->n.size(), H5::PredType::NATIVE_INT, write);
+        ckpt_attr(file, "mem_n", &this->mem->n, 1, H5::PredType::NATIVE_INT, write);
+
+        // the arrays
+        for (auto &a : ckpt_arrays())
+          ckpt_hlpr(file, a.first, *a.second, write);
+      }
+
+      public:
+
+      void checkpoint(const std::string &path) override
+      {
+        ckpt_io(path, true);
+      }
+
+      void restart(const std::string &path) override
+      {
+        ckpt_io(path, false);
+        this->restarted = true;
+        resume = true;
+      }
+
+      protected:
+
+      void record_stats(const std::vector<std::vector<double>> &profs) override
+      {
+        ++stats_cnt;
+        for (std::size_t i = 0; i < profs.size(); ++i)
+          record_stats_hlpr(this->outstats[i].name, profs[i].data(), H5::PredType::NATIVE_DOUBLE, profs[i].size(), 2);
+
+        const typename solver_t::real_t time = this->time;
+        record_stats_hlpr("T", &time, flttype_solver, 1, 1);
+
+        stats_hdfp->flush(H5F_SCOPE_LOCAL);
+      }
+
+      void set_filters()
+      {
+        if (filter == hdf5_filter_e::none) return;
+
+#if defined(USE_MPI)
+#  if !H5_VERSION_GE(1,10,2)
+        // collective writes of filtered datasets are supported since HDF5 1.10.2
+        if (this->mem->distmem.size() > 1)
+        {
+          if (this->mem->distmem.rank() == 0)
+            std::cerr << "libmpdata++: HDF5 older than 1.10.2, output compression disabled under MPI" << std::endl;
+          return;
+        }
+#  endif
+        // all data gets written anyhow, no need to fill compressed chunks beforehand
+        params.setFillTime(H5D_FILL_TIME_NEVER);
+#endif
+
+        if (shuffle) params.setShuffle();
+
+        switch (filter)
+        {
+          case hdf5_filter_e::deflate:
+            params.setDeflate(filter_level);
+            break;
+          case hdf5_filter_e::lz4:
+          case hdf5_filter_e::zstd:
+          {
+            // filter ids registered with The HDF Group
+            const H5Z_filter_t id = filter == hdf5_filter_e::lz4 ? 32004 : 32015;
+            if (H5Zfilter_avail(id) <= 0)
+              throw std::runtime_error(std::string("HDF5 ") + (filter == hdf5_filter_e::lz4 ? "LZ4" : "Zstd") + " filter plugin not available (is HDF5_PLUGIN_PATH set?)");
+            // lz4 takes block size as parameter (0 means default), zstd takes compression level
+            const unsigned int cd_values[1] = {filter == hdf5_filter_e::lz4 ? 0u : unsigned(filter_level)};
+            params.setFilter(id, H5Z_FLAG_MANDATORY, 1, cd_values);
+            break;
+          }
+          default: assert(false);
+        }
       }
 
       std::string base_name()
@@ -234,82 +575,225 @@ namespace libmpdataxx
 
           for (const auto &v : this->outvars)
           {
+            const auto &s = sel.at(v.first);
+
             // creating the user-requested variables
             vars[v.first] = (*hdfp).createDataSet(
               v.second.name,
-              flttype_output,
-              sspace,
-              params
+              v.second.pack16 ? H5::PredType::NATIVE_SHORT : flttype_output,
+              s.full ? sspace : H5::DataSpace(parent_t::n_dims, s.gshape.data()),
+              s.full ? params : s.params
             );
             // TODO: units attribute
 
-            record_dsc_helper(vars[v.first], this->out_data(v.first));
+            // output regions were already copied to contiguous buffers by all threads in record_prep()
+            const typename solver_t::arr_t contiguous_arr = s.full ? contiguous_copy(this->out_data(v.first)) : *s.buf;
+            const auto &shp = s.full ? shape : s.shape, &off = s.full ? offst : s.offst;
+
+            if (v.second.pack16)
+              record_pack16_hlpr(vars[v.first], contiguous_arr, shp, off);
+            else if (v.second.keepbits > 0)
+              record_bitround_hlpr(vars[v.first], contiguous_arr, v.second.keepbits, shp, off);
+            else
+              write_hlpr(vars[v.first], contiguous_arr.data(), flttype_solver, shp, off);
           }
         }
       }
 
       void record_dsc_srfc_helper(const H5::DataSet &dset, const typename solver_t::arr_t &arr)
       {
-        H5::DataSpace space = dset.getSpace();
-        space.selectHyperslab(H5S_SELECT_SET, srfcshape.data(), offst.data());
+        // the surface is written by the processes at the bottom of the domain only
+        blitz::TinyVector<hsize_t, parent_t::n_dims> shp = srfcshape, off = offst;
+        *(off.end()-1) = 0;
+        if (this->mem->grid_size[parent_t::n_dims - 1].first() != 0) shp = 0;
+
         // TODO: some permutation of grid_size instead of the switch
         blitz::Range zro(0,0);
 
-        switch (int(solver_t::n_dims))
+        typename solver_t::arr_t contiguous_arr;
+        if (blitz::product(shp) > 0)
         {
-          case 1:
-          {
-            typename solver_t::arr_t contiguous_arr(1);
-            contiguous_arr = arr(0); // create a copy that is contiguous
-            dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, srfcshape.data()), space, dxpl_id);
-            break;
-          }
-          case 2:
-          {
-            typename solver_t::arr_t contiguous_arr(this->mem->grid_size[0], zro);
-            contiguous_arr = arr(this->mem->grid_size[0], zro); // create a copy that is contiguous
-            dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, srfcshape.data()), space, dxpl_id);
-            break;
-          }
-          case 3:
+          switch (int(solver_t::n_dims))
           {
-            typename solver_t::arr_t contiguous_arr(this->mem->grid_size[0], this->mem->grid_size[1], zro);
-            contiguous_arr = arr(this->mem->grid_size[0], this->mem->grid_size[1], zro); // create a copy that is contiguous
-            dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, srfcshape.data()), space, dxpl_id);
-            break;
-          }
-          default: assert(false);
+            case 1:
+            {
+              contiguous_arr.reference(typename solver_t::arr_t(1));
+              contiguous_arr = arr(0); // create a copy that is contiguous
+              break;
+            }
+            case 2:
+            {
+              contiguous_arr.reference(typename solver_t::arr_t(this->mem->grid_size[0], zro));
+              contiguous_arr = arr(this->mem->grid_size[0], zro); // create a copy that is contiguous
+              break;
+            }
+            case 3:
+            {
+              contiguous_arr.reference(typename solver_t::arr_t(this->mem->grid_size[0], this->mem->grid_size[1], zro));
+              contiguous_arr = arr(this->mem->grid_size[0], this->mem->grid_size[1], zro); // create a copy that is contiguous
+              break;
+            }
+            default: assert(false);
+          };
+        }
+        write_hlpr(dset, contiguous_arr.data(), flttype_solver, shp, off);
+      }
+
+      // a contiguous copy of the domain interior (i.e. without halos)
+      typename solver_t::arr_t contiguous_copy(const typename solver_t::arr_t &arr)
+      {
+        // TODO: some permutation of grid_size instead of the switch
+        switch (int(solver_t::n_dims))
+        {
+          case 1: return arr(this->mem->grid_size[0]).copy();
+          case 2: return arr(this->mem->grid_size[0], this->mem->grid_size[1]).copy();
+          case 3: return arr(this->mem->grid_size[0], this->mem->grid_size[1], this->mem->grid_size[2]).copy();
+          default: assert(false); throw;
         };
       }
 
+      // writing a contiguous array into (a part of) a dataset
+      void write_hlpr(
+        const H5::DataSet &dset,
+        const void *data,
+        const H5::DataType &type,
+        const blitz::TinyVector<hsize_t, parent_t::n_dims> &shp,
+        const blitz::TinyVector<hsize_t, parent_t::n_dims> &off
+      )
+      {
+        H5::DataSpace space = dset.getSpace(), mspace(parent_t::n_dims, shp.data());
+        if (blitz::product(shp) == 0)
+        {
+          // nothing to be written from this process, but it has to take part in collective calls
+          space.selectNone();
+          mspace.selectNone();
+        }
+        else
+          space.selectHyperslab(H5S_SELECT_SET, shp.data(), off.data());
+        dset.write(data, type, mspace, space, dxpl_id);
+      }
+
       void record_dsc_helper(const H5::DataSet &dset, const typename solver_t::arr_t &arr)
       {
-        H5::DataSpace space = dset.getSpace();
-        space.selectHyperslab(H5S_SELECT_SET, shape.data(), offst.data());
-        // TODO: some permutation of grid_size instead of the switch
+        const typename solver_t::arr_t contiguous_arr = contiguous_copy(arr);
+        write_hlpr(dset, contiguous_arr.data(), flttype_solver, shape, offst);
+      }
 
-        switch (int(solver_t::n_dims))
+      // rounding single-precision values to keepbits mantissa bits (round to nearest, ties to even),
+      // the trailing zero bits make the data much more compressible
+      static void bitround(float *data, const std::size_t size, const int keepbits)
+      {
+        const int drop = std::numeric_limits<float>::digits - 1 - keepbits;
+        if (drop <= 0) return;
+
+        const std::uint32_t
+          half = (std::uint32_t(1) << (drop - 1)) - 1,
+          mask = ~((std::uint32_t(1) << drop) - 1);
+
+        for (std::size_t i = 0; i < size; ++i)
         {
-          case 1:
-          {
-            typename solver_t::arr_t contiguous_arr = arr(this->mem->grid_size[0]).copy(); // create a copy that is contiguous
-            dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, shape.data()), space, dxpl_id);
-            break;
-          }
-          case 2:
-          {
-            typename solver_t::arr_t contiguous_arr = arr(this->mem->grid_size[0], this->mem->grid_size[1]).copy(); // create a copy that is contiguous
-            dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, shape.data()), space, dxpl_id);
-            break;
-          }
-          case 3:
+          std::uint32_t bits;
+          std::memcpy(&bits, data + i, sizeof(bits));
+          if ((bits & 0x7f800000) == 0x7f800000) continue; // NaN and Inf left intact (rounding could turn NaN into Inf)
+          bits += half + ((bits >> drop) & 1);
+          bits &= mask;
+          std::memcpy(data + i, &bits, sizeof(bits));
+        }
+      }
+
+      void record_bitround_hlpr(
+        const H5::DataSet &dset,
+        const typename solver_t::arr_t &contiguous_arr,
+        const int keepbits,
+        const blitz::TinyVector<hsize_t, parent_t::n_dims> &shp,
+        const blitz::TinyVector<hsize_t, parent_t::n_dims> &off
+      )
+      {
+        blitz::Array<float, parent_t::n_dims> flt_arr(contiguous_arr.shape());
+        flt_arr = blitz::cast<float>(contiguous_arr);
+        bitround(flt_arr.data(), flt_arr.size(), keepbits);
+
+        write_hlpr(dset, flt_arr.data(), H5::PredType::NATIVE_FLOAT, shp, off);
+      }
+
+      // bit test, as std::isfinite() may be optimised away with -ffast-math (see repro_sum)
+      static bool is_finite(const double x)
+      {
+        std::uint64_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return (bits & 0x7ff0000000000000ULL) != 0x7ff0000000000000ULL;
+      }
+
+      // storing data as 16-bit integers, following the CF packing convention: value = packed * scale_factor + add_offset
+      void record_pack16_hlpr(
+        const H5::DataSet &dset,
+        const typename solver_t::arr_t &contiguous_arr,
+        const blitz::TinyVector<hsize_t, parent_t::n_dims> &shp,
+        const blitz::TinyVector<hsize_t, parent_t::n_dims> &off
+      )
+      {
+        using real_t = typename solver_t::real_t;
+
+        // extrema of the finite values, MPI-aware so that all processes use the same scaling
+        real_t mn = std::numeric_limits<real_t>::max(), mx = -std::numeric_limits<real_t>::max();
+        for (const auto *p = contiguous_arr.data(); p != contiguous_arr.data() + contiguous_arr.size(); ++p)
+        {
+          if (!is_finite(*p)) continue;
+          mn = std::min(mn, *p);
+          mx = std::max(mx, *p);
+        }
+        mn = this->mem->distmem.min(mn);
+        mx = this->mem->distmem.max(mx);
+        if (mn > mx) mn = mx = 0; // no finite values at all
+
+        // the packed range is symmetric, leaving the lowest short value free for the non-finite values
+        const short fill_value = std::numeric_limits<short>::min();
+        const float
+          add_offset = (double(mx) + mn) / 2,
+          scale_factor = mx > mn ? (double(mx) - mn) / (2 * std::numeric_limits<short>::max() - 2) : 1;
+
+        blitz::Array<short, parent_t::n_dims> packed_arr(contiguous_arr.shape());
+        short *q = packed_arr.data();
+        for (const auto *p = contiguous_arr.data(); p != contiguous_arr.data() + contiguous_arr.size(); ++p, ++q)
+          *q = is_finite(*p) ? short(std::floor((*p - add_offset) / scale_factor + .5)) : fill_value;
+
+        write_hlpr(dset, packed_arr.data(), H5::PredType::NATIVE_SHORT, shp, off);
+
+        dset.createAttribute("scale_factor", flttype_output, H5::DataSpace(1, &one)).write(flttype_output, &scale_factor);
+        dset.createAttribute("add_offset", flttype_output, H5::DataSpace(1, &one)).write(flttype_output, &add_offset);
+        dset.createAttribute("_FillValue", H5::PredType::NATIVE_SHORT, H5::DataSpace(1, &one)).write(H5::PredType::NATIVE_SHORT, &fill_value);
+      }
+
+      // copying the output regions into contiguous buffers, each thread handles its own subdomain
+      void record_prep()
+      {
+        parent_t::record_prep();
+
+        for (const auto &v : this->outvars)
+        {
+          const auto &s = sel.at(v.first);
+          if (s.full || blitz::product(s.shape) == 0) continue;
+
+          // part of the region within this thread's subdomain (threads divide the domain in the first dimension)
+          const int str = s.stride[0];
+          const int first = s.rng[0].first() + (std::max(0, this->ijk[0].first() - s.rng[0].first()) + str - 1) / str * str;
+          int last = std::min(this->ijk[0].last(), s.rng[0].last());
+          if (first > last) continue;
+          last = first + (last - first) / str * str;
+
+          const rng_t
+            src(first, last, str),
+            dst((first - s.rng[0].first()) / str, (last - s.rng[0].first()) / str);
+
+          const auto arr = this->out_data(v.first);
+          switch (int(solver_t::n_dims))
           {
-            typename solver_t::arr_t contiguous_arr = arr(this->mem->grid_size[0], this->mem->grid_size[1], this->mem->grid_size[2]).copy(); // create a copy that is contiguous
-            dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, shape.data()), space, dxpl_id);
-            break;
+            case 1: (*s.buf)(dst) = arr(src); break;
+            case 2: (*s.buf)(dst, rng_t::all()) = arr(src, s.rng[1]); break;
+            case 3: (*s.buf)(dst, rng_t::all(), rng_t::all()) = arr(src, s.rng[1], s.rng[2]); break;
+            default: assert(false);
           }
-          default: assert(false);
-        };
+        }
       }
 
       // data is assumed to be contiguous and in the same layout as hdf variable
@@ -422,7 +906,7 @@ namespace libmpdataxx
         record_aux_scalar(name, "/", data);
       }
 
-      // see above, also assumes that z is the last dimension
+      // see above, also assumes that z is the last dimension and that data is the profile of the whole domain
       void record_prof_const(const std::string &name, typename solver_t::real_t *data)
       {
         assert(this->rank == 0);
@@ -433,19 +917,18 @@ namespace libmpdataxx
 #endif
         ); // reopen the const file
 
+        const hsize_t nz = this->mem->distmem.grid_size[parent_t::n_dims - 1];
         auto aux = hdfcp.createDataSet(
           name,
           flttype_output,
-          H5::DataSpace(1, &shape[parent_t::n_dims - 1])
+          H5::DataSpace(1, &nz)
         );
 
 #if defined(USE_MPI)
         if (this->mem->distmem.rank() == 0)
 #endif
         {
-          auto space = aux.getSpace();
-          space.selectHyperslab(H5S_SELECT_SET, &shape[parent_t::n_dims - 1], &offst[parent_t::n_dims - 1]);
-          aux.write(data, flttype_solver, H5::DataSpace(1, &shape[parent_t::n_dims - 1]), space);
+          aux.write(data, flttype_solver, H5::DataSpace(1, &nz), aux.getSpace());
         }
       }
 
@@ -615,11 +1098,24 @@ namespace libmpdataxx
 
       public:
 
+      struct rt_params_t : parent_t::rt_params_t
+      {
+        std::array<int, parent_t::n_dims> hdf5_chunk = {}; // chunk shape, zeros mean the whole (local) domain
+        hdf5_filter_e hdf5_filter = hdf5_filter_e::deflate;
+        int hdf5_filter_level = 5; // deflate (0-9) or zstd (1-22) level, ignored for lz4
+        bool hdf5_shuffle = false; // byte shuffling before compression, usually improves compression of floats
+      };
+
       // ctor
       hdf5(
         typename parent_t::ctor_args_t args,
-        const typename parent_t::rt_params_t &p
-      ) : parent_t(args, p)
+        const rt_params_t &p
+      ) :
+        parent_t(args, p),
+        chunk_req(p.hdf5_chunk),
+        filter(p.hdf5_filter),
+        filter_level(p.hdf5_filter_level),
+        shuffle(p.hdf5_shuffle)
       {
 #if defined(USE_MPI)
         fapl_id = H5Pcreate(H5P_FILE_ACCESS);
@@ -630,6 +1126,58 @@ namespace libmpdataxx
         // overrding the default from output_common
         if (this->outvars.size() == 1 && parent_t::n_eqns == 1)
           this->outvars[0].name = "psi";
+
+        // output regions
+        std::map<std::vector<int>, std::string> roi_names;
+        int n_roi_vars = 0;
+        for (const auto &v : this->outvars)
+        {
+          if (v.second.pack16 && v.second.keepbits > 0)
+            throw std::runtime_error("keepbits and pack16 both set for " + v.second.name + ", choose one of the lossy output options");
+
+          sel_t s;
+          std::vector<int> key;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            const int nn = this->mem->distmem.grid_size[d];
+            s.start[d] = v.second.start[d];
+            s.stride[d] = std::max(1, v.second.stride[d]);
+            s.count[d] = v.second.count[d] > 0 ? v.second.count[d] : (nn - s.start[d] - 1) / s.stride[d] + 1;
+            if (s.start[d] < 0 || s.count[d] < 1 || s.start[d] + (s.count[d] - 1) * s.stride[d] > nn - 1)
+              throw std::runtime_error("output region of " + v.second.name + " exceeds the domain");
+            s.full = s.full && s.start[d] == 0 && s.stride[d] == 1 && s.count[d] == nn;
+            key.insert(key.end(), {s.start[d], s.count[d], s.stride[d]});
+
+            // local part of the region (with MPI, the domain may be divided in any dimension)
+            const int
+              lo = std::max(s.start[d], this->mem->grid_size[d].first()),
+              hi = std::min(s.start[d] + (s.count[d] - 1) * s.stride[d], this->mem->grid_size[d].last()),
+              first = s.start[d] + (lo - s.start[d] + s.stride[d] - 1) / s.stride[d] * s.stride[d];
+            s.gshape[d] = s.count[d];
+            s.shape[d] = first <= hi ? (hi - first) / s.stride[d] + 1 : 0;
+            s.offst[d] = (first - s.start[d]) / s.stride[d];
+            if (s.shape[d] > 0) s.rng[d] = rng_t(first, first + (s.shape[d] - 1) * s.stride[d], s.stride[d]);
+          }
+
+          if (!s.full)
+          {
+            // (emplace, as the order of evaluation of an assignment is unspecified before C++17)
+            s.name = roi_names.emplace(key, "roi" + std::to_string(roi_names.size())).first->second;
+
+            // buffers are shared by all threads, the first thread is constructed first and allocates them
+            if (this->rank == 0)
+            {
+              if (n_roi_vars == 0) this->mem->tmp[__FILE__].push_back(new arrvec_t<typename solver_t::arr_t>());
+              this->mem->tmp[__FILE__].back().push_back(this->mem->old(
+                new typename solver_t::arr_t(blitz::TinyVector<int, parent_t::n_dims>(s.shape)),
+                "output region buffer"
+              ));
+            }
+            s.buf = &this->mem->tmp[__FILE__][0][n_roi_vars++];
+          }
+
+          sel[v.first] = s;
+        }
       }
 
       // dtor
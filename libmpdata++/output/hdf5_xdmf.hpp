@@ -35,10 +35,12 @@ namespace libmpdataxx
 
       static_assert(parent_t::n_dims > 1, "only 2D and 3D output supported");
 
-      std::vector<std::string> timesteps;
       //xdmf writer
       detail::xdmf_writer<parent_t::n_dims> xdmfw;
 
+      // separate xdmf writers for output regions (subsampled variables)
+      std::map<std::string, detail::xdmf_writer<parent_t::n_dims>> roi_xdmfw;
+
       void start(const typename parent_t::advance_arg_t nt)
       {
         parent_t::start(nt);
@@ -49,14 +51,39 @@ namespace libmpdataxx
         {
           // get variable names for xdmf writer setup
           std::vector<std::string> attr_names;
+          std::map<std::string, std::vector<std::string>> roi_attr_names;
           for (const auto &v : this->outvars)
           {
-            attr_names.push_back(v.second.name);
+            const auto &s = this->sel.at(v.first);
+            if (s.full)
+              attr_names.push_back(v.second.name);
+            else
+              roi_attr_names[s.name].push_back(v.second.name);
           }
 
           if (this->mem->G.get() != nullptr) xdmfw.add_const_attribute("G", this->const_name, this->mem->distmem.grid_size.data());
 
           xdmfw.setup(this->const_name, this->dim_names, attr_names, this->mem->distmem.grid_size.data());
+
+          // output regions have their own geometry
+          for (const auto &v : this->outvars)
+          {
+            const auto &s = this->sel.at(v.first);
+            if (s.full || roi_xdmfw.count(s.name) > 0) continue;
+
+            std::map<int, std::string> roi_dim_names;
+            for (const auto &dn : this->dim_names)
+              roi_dim_names[dn.first] = dn.second + "_" + s.name;
+
+            roi_xdmfw[s.name].setup(this->const_name, roi_dim_names, roi_attr_names[s.name], blitz::TinyVector<int, parent_t::n_dims>(s.gshape));
+          }
+
+          // variables packed into 16-bit integers (note: Paraview does not apply the scale_factor and add_offset)
+          for (const auto &v : this->outvars)
+          {
+            const auto &s = this->sel.at(v.first);
+            if (v.second.pack16) (s.full ? xdmfw : roi_xdmfw[s.name]).set_number_type(v.second.name, "Int", 2);
+          }
         }
       }
 
@@ -70,10 +97,16 @@ namespace libmpdataxx
           std::string xmf_name = this->base_name() + ".xmf";
           xdmfw.write(this->outdir + "/" + xmf_name, this->hdf_name(), this->record_time);
 
-          // save the xmf filename for temporal write
-          timesteps.push_back(xmf_name);
-          // write temporal xmf
-          xdmfw.write_temporal(this->outdir + "/temp.xmf", timesteps);
+          // append the xmf filename to the temporal xmf
+          xdmfw.write_temporal(this->outdir + "/temp.xmf", xmf_name, this->resume);
+
+          // ditto for output regions
+          for (auto &rw : roi_xdmfw)
+          {
+            std::string roi_xmf_name = this->base_name() + "_" + rw.first + ".xmf";
+            rw.second.write(this->outdir + "/" + roi_xmf_name, this->hdf_name(), this->record_time);
+            rw.second.write_temporal(this->outdir + "/temp_" + rw.first + ".xmf", roi_xmf_name, this->resume);
+          }
         }
       }
 
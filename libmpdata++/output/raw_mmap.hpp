@@ -0,0 +1,238 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief raw binary output into memory-mapped files (one per variable, [time][x][y][z] layout)
+ *   with an XDMF descriptor, intended for fast-turnaround debugging runs
+ */
+
+#pragma once
+
+#include <libmpdata++/output/detail/output_common.hpp>
+
+#include <boost/filesystem.hpp>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <fstream>
+#include <sstream>
+
+namespace libmpdataxx
+{
+  namespace output
+  {
+    template <class solver_t>
+    class raw_mmap : public detail::output_common<solver_t>
+    {
+      using parent_t = detail::output_common<solver_t>;
+
+      protected:
+
+      using output_t = raw_mmap<solver_t>;
+      using out_t = float; // using floats not to waste disk space (as in the hdf5 output)
+
+      // note: each thread (solver instance) maps the files on its own
+      struct mapping_t
+      {
+        int fd = -1;
+        out_t *ptr = nullptr;
+      };
+      std::map<int, mapping_t> maps;
+
+      blitz::TinyVector<int, parent_t::n_dims> shape; // of the whole domain
+      std::size_t rec_size;  // number of values in a record of a variable
+      long n_rec = 0,        // number of records the files are mapped for
+           rec = 0;          // number of records done
+      bool prepped = false;  // if the current record was filled in record_prep()
+
+      const std::string xmf_name = "raw.xmf";
+      const std::string xmf_footer = "\t\t</Grid>\n\t</Domain>\n</Xdmf>\n";
+
+      std::string bin_path(const int var)
+      {
+        return this->outdir + "/" + bin_name(var);
+      }
+
+      std::string bin_name(const int var)
+      {
+        return this->outvars[var].name + ".bin";
+      }
+
+      // setting the size of the files to n records, the files are shared by all processes
+      void resize_files(const long n)
+      {
+        if (this->mem->distmem.rank() == 0)
+        {
+          for (const auto &v : this->outvars)
+            if (truncate(bin_path(v.first).c_str(), n * rec_size * sizeof(out_t)) != 0)
+              throw std::runtime_error("raw_mmap: cannot resize " + bin_name(v.first));
+        }
+#if defined(USE_MPI)
+        this->mem->distmem.barrier();
+#endif
+      }
+
+      // (re)mapping the whole files (all of the same size, see resize_files)
+      void map_files()
+      {
+        for (const auto &v : this->outvars)
+        {
+          auto &m = maps[v.first];
+          if (m.fd < 0) m.fd = open(bin_path(v.first).c_str(), O_RDWR);
+          if (m.fd < 0) throw std::runtime_error("raw_mmap: cannot open " + bin_name(v.first));
+        }
+
+        struct stat st;
+        if (fstat(maps.begin()->second.fd, &st) != 0) throw std::runtime_error("raw_mmap: cannot stat " + bin_name(maps.begin()->first));
+        const long n_rec_new = st.st_size / (rec_size * sizeof(out_t));
+
+        for (const auto &v : this->outvars)
+        {
+          auto &m = maps[v.first];
+          // unmapped with the length it was mapped with
+          if (m.ptr != nullptr) munmap(m.ptr, n_rec * rec_size * sizeof(out_t));
+          m.ptr = nullptr;
+
+          void *ptr = mmap(nullptr, n_rec_new * rec_size * sizeof(out_t), PROT_READ | PROT_WRITE, MAP_SHARED, m.fd, 0);
+          if (ptr == MAP_FAILED) throw std::runtime_error("raw_mmap: cannot map " + bin_name(v.first));
+          m.ptr = static_cast<out_t*>(ptr);
+        }
+        n_rec = n_rec_new;
+      }
+
+      void start(const typename parent_t::advance_arg_t nt)
+      {
+        if (this->mem->distmem.rank() == 0)
+        {
+          boost::filesystem::create_directory(this->outdir);
+
+          // (re)creating the files
+          for (const auto &v : this->outvars)
+          {
+            const int fd = open(bin_path(v.first).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) throw std::runtime_error("raw_mmap: cannot create " + bin_name(v.first));
+            close(fd);
+          }
+
+          if (parent_t::n_dims > 1)
+          {
+            std::ofstream ofs(this->outdir + "/" + xmf_name, std::ios::trunc);
+            ofs << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                << "<Xdmf Version=\"2.0\">\n"
+                << "\t<Domain>\n"
+                << "\t\t<Grid Name=\"TimeGrid\" GridType=\"Collection\" CollectionType=\"Temporal\">\n"
+                << xmf_footer;
+            if (!ofs) throw std::runtime_error("raw_mmap: error writing " + xmf_name);
+          }
+        }
+
+        resize_files(long(nt / this->outfreq) + 1); // incl. t=0
+      }
+
+      // each thread copies its part of the domain directly into the mapped files
+      void record_prep()
+      {
+        if (maps.empty()) map_files();
+
+        if (rec == n_rec)
+        {
+          // more records than anticipated in start(), e.g. with subsequent advance() calls
+          this->mem->barrier();
+          if (this->rank == 0) resize_files(2 * n_rec);
+          this->mem->barrier();
+          map_files();
+        }
+
+        for (const auto &v : this->outvars)
+        {
+          blitz::Array<out_t, parent_t::n_dims> dst(maps.at(v.first).ptr + rec * rec_size, shape, blitz::neverDeleteData);
+          dst(this->ijk) = this->out_data(v.first)(this->ijk);
+        }
+        ++rec;
+
+        if (this->rank == 0) prepped = true;
+      }
+
+      void record_all()
+      {
+        // another record in the same timestep (see outwindow) would contain the same data
+        if (!prepped) return;
+        prepped = false;
+
+        if (parent_t::n_dims > 1 && this->mem->distmem.rank() == 0) append_xmf(rec - 1);
+      }
+
+      // appending a grid for the current record to the temporal collection
+      // (only the closing tags are overwritten, see also xdmf_writer::write_temporal)
+      void append_xmf(const long r)
+      {
+        std::ostringstream dims, pnts, orig, dxyz;
+        const std::array<typename solver_t::real_t, 3> dijk = {this->di, this->dj, this->dk};
+        for (int d = 0; d < parent_t::n_dims; ++d)
+        {
+          dims << shape[d] << ' ';
+          pnts << shape[d] + 1 << ' ';
+          orig << 0 << ' ';
+          dxyz << dijk[d] << ' ';
+        }
+
+        std::ostringstream ss;
+        ss << "\t\t\t<Grid Name=\"Grid\" GridType=\"Uniform\">\n"
+           << "\t\t\t\t<Time Value=\"" << std::to_string(this->record_time) << "\"/>\n"
+           << "\t\t\t\t<Topology TopologyType=\"" << parent_t::n_dims << "DCoRectMesh\" Dimensions=\"" << pnts.str() << "\"/>\n"
+           << "\t\t\t\t<Geometry GeometryType=\"" << (parent_t::n_dims == 2 ? "ORIGIN_DXDY" : "ORIGIN_DXDYDZ") << "\">\n"
+           << "\t\t\t\t\t<DataItem Dimensions=\"" << parent_t::n_dims << "\" NumberType=\"Float\" Format=\"XML\">" << orig.str() << "</DataItem>\n"
+           << "\t\t\t\t\t<DataItem Dimensions=\"" << parent_t::n_dims << "\" NumberType=\"Float\" Format=\"XML\">" << dxyz.str() << "</DataItem>\n"
+           << "\t\t\t\t</Geometry>\n";
+        for (const auto &v : this->outvars)
+        {
+          ss << "\t\t\t\t<Attribute Name=\"" << v.second.name << "\" AttributeType=\"Scalar\" Center=\"Cell\">\n"
+             << "\t\t\t\t\t<DataItem Dimensions=\"" << dims.str() << "\" NumberType=\"Float\" Precision=\"" << sizeof(out_t) << "\""
+             << " Format=\"Binary\" Endian=\"Native\" Seek=\"" << r * rec_size * sizeof(out_t) << "\">"
+             << bin_name(v.first) << "</DataItem>\n"
+             << "\t\t\t\t</Attribute>\n";
+        }
+        ss << "\t\t\t</Grid>\n";
+
+        std::fstream fs(this->outdir + "/" + xmf_name, std::ios::in | std::ios::out);
+        fs.seekp(-static_cast<std::streamoff>(xmf_footer.size()), std::ios::end);
+        fs << ss.str() << xmf_footer;
+        if (!fs) throw std::runtime_error("raw_mmap: error appending to " + xmf_name);
+      }
+
+      public:
+
+      // ctor
+      raw_mmap(
+        typename parent_t::ctor_args_t args,
+        const typename parent_t::rt_params_t &p
+      ) : parent_t(args, p)
+      {
+        // overrding the default from output_common (as in hdf5 output)
+        if (this->outvars.size() == 1 && parent_t::n_eqns == 1 && this->outvars[0].name.empty())
+          this->outvars[0].name = "psi";
+
+        for (int d = 0; d < parent_t::n_dims; ++d)
+          shape[d] = this->mem->distmem.grid_size[d];
+        rec_size = blitz::product(shape);
+      }
+
+      // dtor
+      virtual ~raw_mmap()
+      {
+        for (auto &m : maps)
+        {
+          if (m.second.ptr != nullptr) munmap(m.second.ptr, n_rec * rec_size * sizeof(out_t));
+          if (m.second.fd >= 0) close(m.second.fd);
+        }
+      }
+    };
+  } // namespace output
+} // namespace libmpdataxx
@@ -65,6 +65,11 @@ namespace libmpdataxx
           {
             parent_t::alloc_tmp_sclr(mem, __FILE__, 1); // hflux_frc
           }
+
+          // set by the user before the run
+          mem->ckpt_tmp["tht_e"] = std::make_pair(__FILE__, 0);
+          mem->ckpt_tmp["tht_abs"] = std::make_pair(__FILE__, 1);
+          mem->ckpt_tmp["hflux_frc"] = std::make_pair(__FILE__, 2);
         }
       };
     } // namespace detail
@@ -55,6 +55,12 @@ namespace libmpdataxx
           parent_t::hook_ante_loop(nt);
         }
 
+        void hook_ante_restart(const typename parent_t::advance_arg_t nt)
+        {
+          calc_dtht_e(); // derived from the checkpointed tht_e
+          parent_t::hook_ante_restart(nt);
+        }
+
         virtual void normalize_vip(const arrvec_t<typename parent_t::arr_t> &v)
         {
           if (static_cast<vip_vab_t>(ct_params_t::vip_vab) == impl)
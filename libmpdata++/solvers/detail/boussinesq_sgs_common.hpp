@@ -144,6 +144,7 @@ namespace libmpdataxx
           parent_t::alloc_tmp_sclr(mem, __FILE__, 1); // full_tht
           parent_t::alloc_tmp_sclr(mem, __FILE__, 1); // tdef_sq
           parent_t::alloc_tmp_sclr(mem, __FILE__, 1, "mix_len");
+          mem->ckpt_tmp["mix_len"] = std::make_pair(__FILE__, mem->tmp[__FILE__].size() - 1); // set by the user before the run
           parent_t::alloc_tmp_vctr(mem, __FILE__); // grad_tht
           parent_t::alloc_tmp_sclr(mem, __FILE__, 1, "", true); // hflux_srfc
         }
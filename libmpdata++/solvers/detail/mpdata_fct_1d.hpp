@@ -30,6 +30,8 @@ namespace libmpdataxx
 
         void fct_init(int e)
         {
+          const auto region = this->timed_region("fct");
+
           const auto i1 = this->i^1; // TODO: isn't it a race condition with more than one thread?
           const auto psi = this->mem->psi[e][this->n[e]];
 
@@ -53,31 +55,37 @@ namespace libmpdataxx
           // fill halos in GC_corr
           this->xchng_vctr_alng(GC_corr, true);
 
-          // calculation of fluxes for betas denominators
-          if (opts::isset(ct_params_t::opts, opts::iga))
-          {
-            this->flux_ptr = &GC_corr;
-          }
-          else
           {
-            this->flux[0](im1+h) = formulae::donorcell::make_flux<ct_params_t::opts>(psi, GC_corr[0], im1);
-            this->flux_ptr = &this->flux;
-          }
+            const auto region = this->timed_region("fct");
+            // calculation of fluxes for betas denominators
+            if (opts::isset(ct_params_t::opts, opts::iga))
+            {
+              this->flux_ptr = &GC_corr;
+            }
+            else
+            {
+              this->flux[0](im1+h) = formulae::donorcell::make_flux<ct_params_t::opts>(psi, GC_corr[0], im1);
+              this->flux_ptr = &this->flux;
+            }
 
-          const auto &flx = (*(this->flux_ptr));
+            const auto &flx = (*(this->flux_ptr));
 
-          // sanity check for input
-          assert(std::isfinite(sum(flx[0](i1^h))));
+            // sanity check for input
+            assert(std::isfinite(sum(flx[0](i1^h))));
 
-          // calculating betas
-          formulae::mpdata::beta_up<ct_params_t::opts>(this->beta_up, psi, this->psi_max, flx, G, i1);
-          formulae::mpdata::beta_dn<ct_params_t::opts>(this->beta_dn, psi, this->psi_min, flx, G, i1);
+            // calculating betas
+            formulae::mpdata::beta_up<ct_params_t::opts>(this->beta_up, psi, this->psi_max, flx, G, i1);
+            formulae::mpdata::beta_dn<ct_params_t::opts>(this->beta_dn, psi, this->psi_min, flx, G, i1);
+          }
 
           // assuring flx, psi_min and psi_max are not overwritten
           this->beta_barrier(iter);
 
-          // calculating the monotonic corrective velocity
-          formulae::mpdata::GC_mono<ct_params_t::opts>(this->GC_mono[d], psi, this->beta_up, this->beta_dn, GC_corr[d], G, im);
+          {
+            const auto region = this->timed_region("fct");
+            // calculating the monotonic corrective velocity
+            formulae::mpdata::GC_mono<ct_params_t::opts>(this->GC_mono[d], psi, this->beta_up, this->beta_dn, GC_corr[d], G, im);
+          }
         }
       };
     } // namespace detail
@@ -30,6 +30,8 @@ namespace libmpdataxx
 
         void fct_init(int e)
         {
+          const auto region = this->timed_region("fct");
+
           const auto i1 = this->i^1, j1 = this->j^1; // not optimal - with multiple threads some indices are repeated among threads
           const auto psi = this->mem->psi[e][this->n[e]];
 
@@ -58,36 +60,42 @@ namespace libmpdataxx
           this->xchng_vctr_alng(GC_corr, true);
           this->xchng_vctr_nrml(this->GC_corr(iter), this->ijk);
 
-          // calculation of fluxes for betas denominators
-          if (opts::isset(ct_params_t::opts, opts::iga))
-          {
-            this->flux_ptr = &GC_corr;
-          }
-          else
           {
-            this->flux[0](im1+h, j1) = formulae::donorcell::make_flux<ct_params_t::opts, 0>(psi, GC_corr[0], im1, j1);
-            this->flux[1](i1, jm1+h) = formulae::donorcell::make_flux<ct_params_t::opts, 1>(psi, GC_corr[1], jm1, i1);
-            this->flux_ptr = &this->flux;
-          }
+            const auto region = this->timed_region("fct");
+            // calculation of fluxes for betas denominators
+            if (opts::isset(ct_params_t::opts, opts::iga))
+            {
+              this->flux_ptr = &GC_corr;
+            }
+            else
+            {
+              this->flux[0](im1+h, j1) = formulae::donorcell::make_flux<ct_params_t::opts, 0>(psi, GC_corr[0], im1, j1);
+              this->flux[1](i1, jm1+h) = formulae::donorcell::make_flux<ct_params_t::opts, 1>(psi, GC_corr[1], jm1, i1);
+              this->flux_ptr = &this->flux;
+            }
 
-          const auto &flx = (*(this->flux_ptr));
+            const auto &flx = (*(this->flux_ptr));
 
-          // calculating betas
-          formulae::mpdata::beta_up<ct_params_t::opts>(this->beta_up, psi, this->psi_max, flx, G, i1, j1);
-          formulae::mpdata::beta_dn<ct_params_t::opts>(this->beta_dn, psi, this->psi_min, flx, G, i1, j1);
+            // calculating betas
+            formulae::mpdata::beta_up<ct_params_t::opts>(this->beta_up, psi, this->psi_max, flx, G, i1, j1);
+            formulae::mpdata::beta_dn<ct_params_t::opts>(this->beta_dn, psi, this->psi_min, flx, G, i1, j1);
 
-          // should detect the need for ext=1 halo-filling above (TODO: double check)
-          assert(std::isfinite(sum(this->beta_up(i1, this->j))));
-          assert(std::isfinite(sum(this->beta_up(this->i, j1))));
-          assert(std::isfinite(sum(this->beta_dn(i1, this->j))));
-          assert(std::isfinite(sum(this->beta_dn(this->i, j1))));
+            // should detect the need for ext=1 halo-filling above (TODO: double check)
+            assert(std::isfinite(sum(this->beta_up(i1, this->j))));
+            assert(std::isfinite(sum(this->beta_up(this->i, j1))));
+            assert(std::isfinite(sum(this->beta_dn(i1, this->j))));
+            assert(std::isfinite(sum(this->beta_dn(this->i, j1))));
+          }
 
           // assuring flx, psi_min and psi_max are not overwritten
           this->beta_barrier(iter);
 
-          // calculating the monotonic corrective velocity
-          formulae::mpdata::GC_mono<ct_params_t::opts, 0>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, im, this->j);
-          formulae::mpdata::GC_mono<ct_params_t::opts, 1>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, jm, this->i);
+          {
+            const auto region = this->timed_region("fct");
+            // calculating the monotonic corrective velocity
+            formulae::mpdata::GC_mono<ct_params_t::opts, 0>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, im, this->j);
+            formulae::mpdata::GC_mono<ct_params_t::opts, 1>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, jm, this->i);
+          }
         }
       };
     } // namespace detail
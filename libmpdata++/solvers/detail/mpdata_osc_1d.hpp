@@ -32,7 +32,7 @@ namespace libmpdataxx
 
         protected:
 
-        const rng_t im;
+        rng_t im;
 
         void hook_ante_loop(const typename parent_t::advance_arg_t nt)
         {
@@ -66,18 +66,21 @@ namespace libmpdataxx
               this->cycle(e); // cycles subdomain's "n", and global "n" if it's the last equation
               this->xchng(e);
 
-              // calculating the antidiffusive C
-              formulae::mpdata::antidiff<ct_params_t::opts,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[0],
-                this->mem->psi[e][this->n[e]],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                im
-              );
+              {
+                const auto region = this->timed_region("antidiff");
+                // calculating the antidiffusive C
+                formulae::mpdata::antidiff<ct_params_t::opts,
+                                           static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                           static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+                  this->GC_corr(iter)[0],
+                  this->mem->psi[e][this->n[e]],
+                  this->GC_unco(iter),
+                  this->mem->ndt_GC,
+                  this->mem->ndtt_GC,
+                  *this->mem->G,
+                  im
+                );
+              }
 
               // needed with the dfl option
               // if we aren't in the last iteration and fct is not set
@@ -91,36 +94,42 @@ namespace libmpdataxx
               this->fct_adjust_antidiff(e, iter); // i.e. calculate GC_mono=GC_mono(GC_corr) in FCT
             }
 
-            // calculation of fluxes
-            if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
-            {
-              this->flux[0](im+h) = formulae::donorcell::make_flux<ct_params_t::opts>(
-                this->mem->psi[e][this->n[e]],
-                this->GC(iter)[0],
-                im
-              );
-              this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
-            }
-            else
             {
-              assert(iter == 1); // infinite gauge option uses just one corrective step // TODO: not true?
-              this->flux_ptr = &this->GC(iter); // TODO: move to common
+              const auto region = this->timed_region("flux");
+              // calculation of fluxes
+              if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
+              {
+                this->flux[0](im+h) = formulae::donorcell::make_flux<ct_params_t::opts>(
+                  this->mem->psi[e][this->n[e]],
+                  this->GC(iter)[0],
+                  im
+                );
+                this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
+              }
+              else
+              {
+                assert(iter == 1); // infinite gauge option uses just one corrective step // TODO: not true?
+                this->flux_ptr = &this->GC(iter); // TODO: move to common
+              }
             }
 
             // sanity checks for input // TODO: move to common
             //assert(std::isfinite(sum(psi[this->n[e]](this->ijk))));
             //assert(std::isfinite(sum(flux_ref[0](i^h))));
 
-            // donor-cell call // TODO: could be made common for 1D/2D/3D
-            formulae::donorcell::donorcell_sum<ct_params_t::opts>(
-              this->mem->khn_tmp,
-              this->ijk,
-              this->mem->psi[e][this->n[e]+1](this->ijk),
-              this->mem->psi[e][this->n[e]  ](this->ijk),
-              (*(this->flux_ptr))[0](this->i+h),
-              (*(this->flux_ptr))[0](this->i-h),
-              formulae::G<ct_params_t::opts>(*this->mem->G, this->i)
-            );
+            {
+              const auto region = this->timed_region("donorcell");
+              // donor-cell call // TODO: could be made common for 1D/2D/3D
+              formulae::donorcell::donorcell_sum<ct_params_t::opts>(
+                this->mem->khn_tmp,
+                this->ijk,
+                this->mem->psi[e][this->n[e]+1](this->ijk),
+                this->mem->psi[e][this->n[e]  ](this->ijk),
+                (*(this->flux_ptr))[0](this->i+h),
+                (*(this->flux_ptr))[0](this->i-h),
+                formulae::G<ct_params_t::opts>(*this->mem->G, this->i)
+              );
+            }
 
             if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
             {
@@ -165,6 +174,12 @@ namespace libmpdataxx
         }
 
 
+        void set_ijk(const idx_t<1> &ijk_) override
+        {
+          parent_t::set_ijk(ijk_);
+          im = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
+        }
+
         public:
 
         // ctor
@@ -35,7 +35,7 @@ namespace libmpdataxx
         protected:
 
         // member fields
-        const rng_t im, jm;
+        rng_t im, jm;
 
         void hook_ante_loop(const typename parent_t::advance_arg_t nt)
         {
@@ -78,36 +78,39 @@ namespace libmpdataxx
               this->cycle(e);
               this->xchng(e);
 
-              // calculating the antidiffusive C
-              formulae::mpdata::antidiff<ct_params_t::opts, 0,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[0],
-                this->mem->psi[e][this->n[e]],
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->im,
-                this->j
-              );
-              assert(std::isfinite(sum(this->GC_corr(iter)[0](this->im+h, this->j))));
-
-              formulae::mpdata::antidiff<ct_params_t::opts, 1,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[1],
-                this->mem->psi[e][this->n[e]],
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->jm,
-                this->i
-              );
-              assert(std::isfinite(sum(this->GC_corr(iter)[1](this->i, this->jm+h))));
+              {
+                const auto region = this->timed_region("antidiff");
+                // calculating the antidiffusive C
+                formulae::mpdata::antidiff<ct_params_t::opts, 0,
+                                           static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                           static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+                  this->GC_corr(iter)[0],
+                  this->mem->psi[e][this->n[e]],
+                  this->mem->psi[e][this->n[e]-1],
+                  this->GC_unco(iter),
+                  this->mem->ndt_GC,
+                  this->mem->ndtt_GC,
+                  *this->mem->G,
+                  this->im,
+                  this->j
+                );
+                assert(std::isfinite(sum(this->GC_corr(iter)[0](this->im+h, this->j))));
+
+                formulae::mpdata::antidiff<ct_params_t::opts, 1,
+                                           static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                           static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+                  this->GC_corr(iter)[1],
+                  this->mem->psi[e][this->n[e]],
+                  this->mem->psi[e][this->n[e]-1],
+                  this->GC_unco(iter),
+                  this->mem->ndt_GC,
+                  this->mem->ndtt_GC,
+                  *this->mem->G,
+                  this->jm,
+                  this->i
+                );
+                assert(std::isfinite(sum(this->GC_corr(iter)[1](this->i, this->jm+h))));
+              }
 
               if (opts::isset(ct_params_t::opts, opts::div_3rd_dt))
                 this->mem->barrier();
@@ -130,25 +133,28 @@ namespace libmpdataxx
               // TODO: shouldn't the above halo-filling be repeated here?
             }
 
-            // calculation of fluxes
-            if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
-            {
-              this->flux[0](im+h, this->j) = formulae::donorcell::make_flux<ct_params_t::opts, 0>(
-                this->mem->psi[e][this->n[e]],
-                this->GC(iter)[0],
-                im, this->j
-              );
-              this->flux[1](this->i, jm+h) = formulae::donorcell::make_flux<ct_params_t::opts, 1>(
-                this->mem->psi[e][this->n[e]],
-                this->GC(iter)[1],
-                jm, this->i
-              );
-              this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
-            }
-            else
             {
-              assert(iter == 1); // infinite gauge option uses just one corrective step // TODO: not true?
-              this->flux_ptr = &this->GC(iter);
+              const auto region = this->timed_region("flux");
+              // calculation of fluxes
+              if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
+              {
+                this->flux[0](im+h, this->j) = formulae::donorcell::make_flux<ct_params_t::opts, 0>(
+                  this->mem->psi[e][this->n[e]],
+                  this->GC(iter)[0],
+                  im, this->j
+                );
+                this->flux[1](this->i, jm+h) = formulae::donorcell::make_flux<ct_params_t::opts, 1>(
+                  this->mem->psi[e][this->n[e]],
+                  this->GC(iter)[1],
+                  jm, this->i
+                );
+                this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
+              }
+              else
+              {
+                assert(iter == 1); // infinite gauge option uses just one corrective step // TODO: not true?
+                this->flux_ptr = &this->GC(iter);
+              }
             }
 
             auto &flx = (*(this->flux_ptr));
@@ -159,19 +165,22 @@ namespace libmpdataxx
             //assert(std::isfinite(sum(flx[0](i^h, j  ))));
             //assert(std::isfinite(sum(flx[1](i,   j^h))));
 
-            // donor-cell call
-            // TODO: doing antidiff,upstream,antidiff,upstream (for each dimension separately) could help optimise memory consumption!
-            formulae::donorcell::donorcell_sum<ct_params_t::opts>(
-              this->mem->khn_tmp,
-              this->ijk,
-              this->mem->psi[e][this->n[e]+1](this->ijk),
-              this->mem->psi[e][this->n[e]  ](this->ijk),
-              flx[0](this->i+h, this->j  ),
-              flx[0](this->i-h, this->j  ),
-              flx[1](this->i,   this->j+h),
-              flx[1](this->i,   this->j-h),
-              formulae::G<ct_params_t::opts, 0>(*this->mem->G, this->i, this->j)
-            );
+            {
+              const auto region = this->timed_region("donorcell");
+              // donor-cell call
+              // TODO: doing antidiff,upstream,antidiff,upstream (for each dimension separately) could help optimise memory consumption!
+              formulae::donorcell::donorcell_sum<ct_params_t::opts>(
+                this->mem->khn_tmp,
+                this->ijk,
+                this->mem->psi[e][this->n[e]+1](this->ijk),
+                this->mem->psi[e][this->n[e]  ](this->ijk),
+                flx[0](this->i+h, this->j  ),
+                flx[0](this->i-h, this->j  ),
+                flx[1](this->i,   this->j+h),
+                flx[1](this->i,   this->j-h),
+                formulae::G<ct_params_t::opts, 0>(*this->mem->G, this->i, this->j)
+              );
+            }
 
             if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
             {
@@ -222,6 +231,13 @@ namespace libmpdataxx
           assert(std::isfinite(sum(field(ijk))));
         }
 
+        void set_ijk(const idx_t<2> &ijk_) override
+        {
+          parent_t::set_ijk(ijk_);
+          im = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
+          jm = rng_t(this->ijk[1].first() - 1, this->ijk[1].last());
+        }
+
         public:
 
         // ctor
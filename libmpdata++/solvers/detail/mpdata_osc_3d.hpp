@@ -35,7 +35,7 @@ namespace libmpdataxx
         protected:
 
         // member fields
-        const rng_t im, jm, km;
+        rng_t im, jm, km;
 
         void hook_ante_loop(const typename parent_t::advance_arg_t nt)
         {
@@ -81,51 +81,54 @@ namespace libmpdataxx
               this->cycle(e);
               this->xchng(e);
 
-              // calculating the antidiffusive C
-              formulae::mpdata::antidiff<ct_params_t::opts, 0,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[0],
-                this->mem->psi[e][this->n[e]],
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->im,
-                this->j,
-                this->k
-              );
-
-              formulae::mpdata::antidiff<ct_params_t::opts, 1,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[1],
-                this->mem->psi[e][this->n[e]],
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->jm,
-                this->k,
-                this->i
-              );
-
-              formulae::mpdata::antidiff<ct_params_t::opts, 2,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[2],
-                this->mem->psi[e][this->n[e]],
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->km,
-                this->i,
-                this->j
-              );
+              {
+                const auto region = this->timed_region("antidiff");
+                // calculating the antidiffusive C
+                formulae::mpdata::antidiff<ct_params_t::opts, 0,
+                                           static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                           static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+                  this->GC_corr(iter)[0],
+                  this->mem->psi[e][this->n[e]],
+                  this->mem->psi[e][this->n[e]-1],
+                  this->GC_unco(iter),
+                  this->mem->ndt_GC,
+                  this->mem->ndtt_GC,
+                  *this->mem->G,
+                  this->im,
+                  this->j,
+                  this->k
+                );
+
+                formulae::mpdata::antidiff<ct_params_t::opts, 1,
+                                           static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                           static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+                  this->GC_corr(iter)[1],
+                  this->mem->psi[e][this->n[e]],
+                  this->mem->psi[e][this->n[e]-1],
+                  this->GC_unco(iter),
+                  this->mem->ndt_GC,
+                  this->mem->ndtt_GC,
+                  *this->mem->G,
+                  this->jm,
+                  this->k,
+                  this->i
+                );
+
+                formulae::mpdata::antidiff<ct_params_t::opts, 2,
+                                           static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                           static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+                  this->GC_corr(iter)[2],
+                  this->mem->psi[e][this->n[e]],
+                  this->mem->psi[e][this->n[e]-1],
+                  this->GC_unco(iter),
+                  this->mem->ndt_GC,
+                  this->mem->ndtt_GC,
+                  *this->mem->G,
+                  this->km,
+                  this->i,
+                  this->j
+                );
+              }
 
               if (opts::isset(ct_params_t::opts, opts::div_3rd_dt))
                 this->mem->barrier();
@@ -153,18 +156,21 @@ namespace libmpdataxx
             auto &GC(this->GC(iter));
             using namespace formulae::donorcell;
 
-            // calculation of fluxes
-            if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
             {
-              this->flux[0](im+h, j, k) = make_flux<ct_params_t::opts, 0>(psi[n], GC[0], im, j, k);
-              this->flux[1](i, jm+h, k) = make_flux<ct_params_t::opts, 1>(psi[n], GC[1], jm, k, i);
-              this->flux[2](i, j, km+h) = make_flux<ct_params_t::opts, 2>(psi[n], GC[2], km, i, j);
-              this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
-            }
-            else
-            {
-              assert(iter == 1); // infinite gauge option uses just one corrective step // TODO: not true?
-              this->flux_ptr = &GC;
+              const auto region = this->timed_region("flux");
+              // calculation of fluxes
+              if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
+              {
+                this->flux[0](im+h, j, k) = make_flux<ct_params_t::opts, 0>(psi[n], GC[0], im, j, k);
+                this->flux[1](i, jm+h, k) = make_flux<ct_params_t::opts, 1>(psi[n], GC[1], jm, k, i);
+                this->flux[2](i, j, km+h) = make_flux<ct_params_t::opts, 2>(psi[n], GC[2], km, i, j);
+                this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
+              }
+              else
+              {
+                assert(iter == 1); // infinite gauge option uses just one corrective step // TODO: not true?
+                this->flux_ptr = &GC;
+              }
             }
 
             auto &flx = (*(this->flux_ptr));
@@ -176,21 +182,24 @@ namespace libmpdataxx
             assert(std::isfinite(sum(flx[1](i,   j^h, k  ))));
             assert(std::isfinite(sum(flx[2](i,   j,   k^h))));
 
-            // donor-cell call
-            // TODO: doing antidiff,upstream,antidiff,upstream (for each dimension separately) could help optimise memory consumption!
-            donorcell_sum<ct_params_t::opts>(
-              this->mem->khn_tmp,
-              ijk,
-              psi[n+1](ijk),
-              psi[n  ](ijk),
-              flx[0](i+h, j,   k  ),
-              flx[0](i-h, j,   k  ),
-              flx[1](i,   j+h, k  ),
-              flx[1](i,   j-h, k  ),
-              flx[2](i,   j,   k+h),
-              flx[2](i,   j,   k-h),
-              formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k)
-            );
+            {
+              const auto region = this->timed_region("donorcell");
+              // donor-cell call
+              // TODO: doing antidiff,upstream,antidiff,upstream (for each dimension separately) could help optimise memory consumption!
+              donorcell_sum<ct_params_t::opts>(
+                this->mem->khn_tmp,
+                ijk,
+                psi[n+1](ijk),
+                psi[n  ](ijk),
+                flx[0](i+h, j,   k  ),
+                flx[0](i-h, j,   k  ),
+                flx[1](i,   j+h, k  ),
+                flx[1](i,   j-h, k  ),
+                flx[2](i,   j,   k+h),
+                flx[2](i,   j,   k-h),
+                formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k)
+              );
+            }
 
             if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
             {
@@ -245,6 +254,14 @@ namespace libmpdataxx
           assert(std::isfinite(sum(field(ijk))));
         }
 
+        void set_ijk(const idx_t<3> &ijk_) override
+        {
+          parent_t::set_ijk(ijk_);
+          im = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
+          jm = rng_t(this->ijk[1].first() - 1, this->ijk[1].last());
+          km = rng_t(this->ijk[2].first() - 1, this->ijk[2].last());
+        }
+
         public:
 
         // ctor
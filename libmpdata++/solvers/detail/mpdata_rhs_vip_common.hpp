@@ -332,7 +332,10 @@ namespace libmpdataxx
 
           // intentionally after stash !!!
           // (we have to stash data from the current time step before applying any forcings to it)
-          vip_rhs_expl_calc();
+          {
+            const auto region = this->timed_region("vip_rhs_expl_calc");
+            vip_rhs_expl_calc();
+          }
           // finish calculating velocity forces before moving on
           this->mem->barrier();
 
@@ -360,7 +363,9 @@ namespace libmpdataxx
           parent_t::alloc(mem, n_iters);
           parent_t::alloc_tmp_sclr(mem, __FILE__,
             (parent_t::div3_mpdata ? 3 : ct_params_t::var_dt ? 2 : 1) * parent_t::n_dims); // stash
+          mem->ckpt_tmp["vip_stash"] = std::make_pair(__FILE__, mem->tmp[__FILE__].size() - 1);
           parent_t::alloc_tmp_sclr(mem, __FILE__, parent_t::n_dims); // vip_rhs
+          mem->ckpt_tmp["vip_rhs"] = std::make_pair(__FILE__, mem->tmp[__FILE__].size() - 1); // applied at the beginning of the next step
         }
 
         protected:
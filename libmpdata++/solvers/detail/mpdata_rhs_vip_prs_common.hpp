@@ -39,12 +39,16 @@ namespace libmpdataxx
 
         real_t prs_sum(const arr_t &arr, const ijk_t &ijk)
         {
-          return this->mem->sum(this->rank, arr, ijk, ct_params_t::prs_khn);
+          return ct_params_t::prs_repro
+            ? this->mem->sum_repro(this->rank, arr, ijk)
+            : this->mem->sum(this->rank, arr, ijk, ct_params_t::prs_khn);
         }
 
         real_t prs_sum(const arr_t &arr1, const arr_t &arr2, const ijk_t &ijk)
         {
-          return this->mem->sum(this->rank, arr1, arr2, ijk, ct_params_t::prs_khn);
+          return ct_params_t::prs_repro
+            ? this->mem->sum_repro(this->rank, arr1, arr2, ijk)
+            : this->mem->sum(this->rank, arr1, arr2, ijk, ct_params_t::prs_khn);
         }
 
         auto lap(
@@ -106,7 +110,10 @@ namespace libmpdataxx
           }
 
           //initial error
-          err(this->ijk) = lap(Phi, this->ijk, this->dijk, true, simple);
+          {
+            const auto region = this->timed_region("lap");
+            err(this->ijk) = lap(Phi, this->ijk, this->dijk, true, simple);
+          }
 
           iters = 0;
           converged = false;
@@ -115,7 +122,10 @@ namespace libmpdataxx
           //pseudo-time loop
           while (!converged)
           {
-            pressure_solver_loop_body(simple);
+            {
+              const auto region = this->timed_region("pressure_solver_iter", iters);
+              pressure_solver_loop_body(simple);
+            }
             iters++;
 
             if (iters > 10000) // going beyond 10000 iters means something is really wrong,
@@ -147,7 +157,10 @@ namespace libmpdataxx
           Phi(this->ijk) = real_t(0);
           this->xchng_pres(Phi, this->ijk);
 
-          pressure_solver_update(true);
+          {
+            const auto region = this->timed_region("pressure_solver_update");
+            pressure_solver_update(true);
+          }
 
           this->xchng_pres(this->Phi, this->ijk);
           formulae::nabla::calc_grad<parent_t::n_dims>(tmp_uvw, Phi, this->ijk, this->dijk);
@@ -168,6 +181,15 @@ namespace libmpdataxx
           }
         }
 
+        void hook_ante_restart(const typename parent_t::advance_arg_t nt)
+        {
+          // edge velocities kept by the open boundary conditions,
+          // each step ends with setting them on the velocity field (see vip_rhs_impl_fnlz)
+          this->save_edges(this->vips(), this->ijk);
+
+          parent_t::hook_ante_restart(nt);
+        }
+
         void vip_rhs_impl_fnlz()
         {
           for (int d = 0; d < parent_t::n_dims; ++d)
@@ -176,7 +198,10 @@ namespace libmpdataxx
           }
 
           if (static_cast<vip_vab_t>(ct_params_t::vip_vab) == impl) this->add_relax();
-          pressure_solver_update();   // intentionally after forcings (pressure solver must be used after all known forcings are applied)
+          {
+            const auto region = this->timed_region("pressure_solver_update");
+            pressure_solver_update();   // intentionally after forcings (pressure solver must be used after all known forcings are applied)
+          }
           pressure_solver_apply();
           this->normalize_vip(this->vips());
           this->set_edges(this->vips(), this->ijk, 1);
@@ -215,6 +240,7 @@ namespace libmpdataxx
         ) {
           parent_t::alloc(mem, n_iters);
           parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // Phi, err
+          mem->ckpt_tmp["Phi"] = std::make_pair(__FILE__, mem->tmp[__FILE__].size() - 1); // first guess for the pressure solver
           parent_t::alloc_tmp_sclr(mem, __FILE__, parent_t::n_dims); // tmp_uvw
           parent_t::alloc_tmp_sclr(mem, __FILE__, parent_t::n_dims); // lap_tmp
         }
@@ -39,7 +39,10 @@ namespace libmpdataxx
         void pressure_solver_loop_init(bool simple) final
         {
           p_err[0](this->ijk) = this->err(this->ijk);
-          lap_p_err[0](this->ijk) = this->lap(p_err[0], this->ijk, this->dijk, false, simple);
+          {
+            const auto region = this->timed_region("lap");
+            lap_p_err[0](this->ijk) = this->lap(p_err[0], this->ijk, this->dijk, false, simple);
+          }
         }
 
         void pressure_solver_loop_body(bool simple) final
@@ -58,7 +61,10 @@ namespace libmpdataxx
 
             if (error <= this->err_tol) this->converged = true;
 
-            lap_err(this->ijk) = this->lap(this->err, this->ijk, this->dijk, false, simple);
+            {
+              const auto region = this->timed_region("lap");
+              lap_err(this->ijk) = this->lap(this->err, this->ijk, this->dijk, false, simple);
+            }
 
             for (int l = 0; l <= v; ++l)
             {
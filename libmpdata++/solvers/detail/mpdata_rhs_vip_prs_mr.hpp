@@ -39,7 +39,10 @@ namespace libmpdataxx
 
         void pressure_solver_loop_body(bool simple) final
         {
-          this->lap_err(this->ijk) = this->lap(this->err, this->ijk, this->dijk, false, simple);
+          {
+            const auto region = this->timed_region("lap");
+            this->lap_err(this->ijk) = this->lap(this->err, this->ijk, this->dijk, false, simple);
+          }
 
           tmp_den = this->prs_sum(this->lap_err, this->lap_err, this->ijk);
           if (tmp_den != 0) beta = - this->prs_sum(this->err, this->lap_err, this->ijk) / tmp_den;
@@ -43,14 +43,20 @@ namespace libmpdataxx
           q_err(this->ijk) = real_t(0);
 
           //initail preconditioner error
-          this->pcnd_err(this->ijk) = this->lap(this->q_err, this->ijk, this->dijk, false, simple) - this->err(this->ijk);
+          {
+            const auto region = this->timed_region("lap");
+            this->pcnd_err(this->ijk) = this->lap(this->q_err, this->ijk, this->dijk, false, simple) - this->err(this->ijk);
+          }
             //TODO does it change with non_const density?
 
           assert(pc_iters >= 0 && pc_iters < 10 && "params.pc_iters not specified?");
           for (int it=0; it<=pc_iters; it++)
           {
             q_err(this->ijk)    += real_t(.25) * pcnd_err(this->ijk);
-            pcnd_err(this->ijk) += real_t(.25) * this->lap(this->pcnd_err, this->ijk, this->dijk);
+            {
+              const auto region = this->timed_region("lap");
+              pcnd_err(this->ijk) += real_t(.25) * this->lap(this->pcnd_err, this->ijk, this->dijk);
+            }
           }
         }
 
@@ -58,7 +64,10 @@ namespace libmpdataxx
         {
           precond(simple);
           p_err(this->ijk) = q_err(this->ijk);
-          this->lap_p_err(this->ijk) = this->lap(this->p_err, this->ijk, this->dijk, false, simple);
+          {
+            const auto region = this->timed_region("lap");
+            this->lap_p_err(this->ijk) = this->lap(this->p_err, this->ijk, this->dijk, false, simple);
+          }
         }
 
         void pressure_solver_loop_body(bool simple) final
@@ -78,7 +87,10 @@ namespace libmpdataxx
 
           precond();
 
-          this->lap_q_err(this->ijk) = this->lap(this->q_err, this->ijk, this->dijk, false, simple);
+          {
+            const auto region = this->timed_region("lap");
+            this->lap_q_err(this->ijk) = this->lap(this->q_err, this->ijk, this->dijk, false, simple);
+          }
 
           if (tmp_den != 0) alpha = -this->prs_sum(lap_q_err, lap_p_err, this->ijk) / tmp_den;
 
@@ -64,6 +64,32 @@ namespace libmpdataxx
 
         real_t cdrag;
 
+        void set_ijkm()
+        {
+          for (int d = 0; d < ct_params_t::n_dims; ++d)
+          {
+            ijkm.lbound()(d) = this->ijk[d].first() - 1;
+            ijkm.ubound()(d) = this->ijk[d].last();
+
+            ijk_vec[d] = rng_t(this->ijk[d].first(),     this->ijk[d].last());
+          }
+          if (this->rank == 0)
+            ijk_vec[0] = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
+
+          ijkm_sep = ijkm;
+          if (this->rank > 0)
+          {
+            ijkm.lbound()(0) = this->ijk[0].first();
+            ijkm.ubound()(0) = this->ijk[0].last();
+          }
+        }
+
+        void set_ijk(const idx_t<ct_params_t::n_dims> &ijk_) override
+        {
+          parent_t::set_ijk(ijk_);
+          set_ijkm();
+        }
+
         virtual void multiply_sgs_visc() = 0;
 
         virtual void calc_drag_cmpct()
@@ -155,11 +181,10 @@ namespace libmpdataxx
             // multiply deformation tensor by sgs viscosity to obtain stress tensor
             multiply_sgs_visc();
 
-            // TODO: get rid of superfluous barriers
-            for (auto& t : tau)
-            {
-              this->xchng_sclr(t, this->ijk);
-            }
+            // halos of all the components exchanged at once
+            std::vector<typename parent_t::arr_t*> taus;
+            for (auto& t : tau) taus.push_back(&t);
+            this->xchng_sclr(taus, this->ijk);
             // calculate elements of stress tensor divergence
             formulae::stress::calc_stress_div<ct_params_t::n_dims>(drv, tau, this->ijk, this->dijk);
 
@@ -195,22 +220,7 @@ namespace libmpdataxx
           wrk(args.mem->tmp[__FILE__][4]),
           cdrag(p.cdrag)
         {
-          for (int d = 0; d < ct_params_t::n_dims; ++d)
-          {
-            ijkm.lbound()(d) = this->ijk[d].first() - 1;
-            ijkm.ubound()(d) = this->ijk[d].last();
-
-            ijk_vec[d] = rng_t(this->ijk[d].first(),     this->ijk[d].last());
-          }
-          if (this->rank == 0)
-            ijk_vec[0] = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
-
-          ijkm_sep = ijkm;
-          if (this->rank > 0)
-          {
-            ijkm.lbound()(0) = this->ijk[0].first();
-            ijkm.ubound()(0) = this->ijk[0].last();
-          }
+          set_ijkm();
         }
 
         static void alloc(
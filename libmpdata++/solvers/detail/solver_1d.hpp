@@ -31,13 +31,14 @@ namespace libmpdataxx
 
         protected:
 
-        const rng_t i; //TODO: to be removed
+        rng_t i; //TODO: to be removed
 
         // generic field used for various statistics (currently Courant number and divergence)
         typename parent_t::arr_t &stat_field; // TODO: should be in solver common but cannot be allocated there ?
 
         virtual void xchng_sclr(typename parent_t::arr_t &arr, const bool deriv = false) final // for a given array
         {
+          const auto region = this->timed_region("xchng_sclr");
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, deriv);
           this->mem->barrier();
@@ -47,16 +48,34 @@ namespace libmpdataxx
         // should be only used with cyclic boundary conditions where xchng_pres == xchng_sclr
         virtual void xchng_pres(typename parent_t::arr_t &arr, const idx_t<1>&, const int ext = 0) final
         {
+          const auto region = this->timed_region("xchng_pres");
           xchng_sclr(arr);
         }
 
+        // halos of several arrays exchanged at once (single message per neighbour with remote bcond)
+        void xchng_sclr(const std::vector<typename parent_t::arr_t*> &arrs, const bool deriv = false)
+        {
+          const auto region = this->timed_region("xchng_sclr");
+          this->mem->barrier();
+          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr_batch(arrs, deriv);
+          this->mem->barrier();
+        }
+
         void xchng(int e) final
         {
           xchng_sclr(this->mem->psi[e][ this->n[e]]);
         }
 
+        void xchng_batch(const std::vector<int> &es) final
+        {
+          std::vector<typename parent_t::arr_t*> arrs;
+          for (auto e : es) arrs.push_back(&this->mem->psi[e][ this->n[e]]);
+          xchng_sclr(arrs);
+        }
+
         void xchng_vctr_alng(arrvec_t<typename parent_t::arr_t> &arrvec, const bool ad = false, const bool cyclic = false) final
         {
+          const auto region = this->timed_region("xchng_vctr_alng");
           this->mem->barrier();
           if (!cyclic)
           {
@@ -127,6 +146,12 @@ namespace libmpdataxx
           this->set_bcs(0, args.bcxl, args.bcxr);
         }
 
+        void set_ijk(const idx_t<1> &ijk_) override
+        {
+          parent_t::set_ijk(ijk_);
+          i = ijk_[0];
+        }
+
         // memory allocation logic using static methods
 
         private:
@@ -146,7 +171,7 @@ namespace libmpdataxx
           for (int n = 0; n < n_arr; ++n)
           {
             mem->tmp[__file__].back().push_back(
-              mem->old(new typename parent_t::arr_t( rng ))
+              mem->old(mem->new_arr( rng ), name.empty() ? "tmp" : name.c_str(), __file__)
             );
           }
         }
@@ -160,9 +185,9 @@ namespace libmpdataxx
           mem->psi.resize(parent_t::n_eqns);
           for (int e = 0; e < parent_t::n_eqns; ++e) // equations
             for (int n = 0; n < n_tlev; ++n) // time levels
-              mem->psi[e].push_back(mem->old(new typename parent_t::arr_t(parent_t::rng_sclr(mem->grid_size[0]))));
+              mem->psi[e].push_back(mem->old_shared("psi", __FILE__, parent_t::rng_sclr(mem->grid_size[0])));
 
-          mem->GC.push_back(mem->old(new typename parent_t::arr_t(parent_t::rng_vctr(mem->grid_size[0]))));
+          mem->GC.push_back(mem->old_shared("GC", __FILE__, parent_t::rng_vctr(mem->grid_size[0])));
 
           // fully third-order accurate mpdata needs also time derivatives of
           // the Courant field
@@ -170,19 +195,19 @@ namespace libmpdataxx
               opts::isset(ct_params_t::opts, opts::div_3rd_dt))
           {
             // TODO: why for (auto f : {mem->ndt_GC, mem->ndtt_GC}) doesn't work ?
-            mem->ndt_GC.push_back(mem->old(new typename parent_t::arr_t(parent_t::rng_vctr(mem->grid_size[0]))));
-            mem->ndtt_GC.push_back(mem->old(new typename parent_t::arr_t(parent_t::rng_vctr(mem->grid_size[0]))));
+            mem->ndt_GC.push_back(mem->old(mem->new_arr(parent_t::rng_vctr(mem->grid_size[0])), "ndt_GC"));
+            mem->ndtt_GC.push_back(mem->old(mem->new_arr(parent_t::rng_vctr(mem->grid_size[0])), "ndtt_GC"));
           }
 
           if (opts::isset(ct_params_t::opts, opts::nug))
-            mem->G.reset(mem->old(new typename parent_t::arr_t(parent_t::rng_sclr(mem->grid_size[0]))));
+            mem->G.reset(mem->old(mem->new_arr(parent_t::rng_sclr(mem->grid_size[0])), "G"));
 
           // allocate Kahan summation temporary vars
           if (opts::isset(ct_params_t::opts, opts::khn))
             for (int n = 0; n < 3; ++n)
-              mem->khn_tmp.push_back(mem->old(new typename parent_t::arr_t(
+              mem->khn_tmp.push_back(mem->old(mem->new_arr(
                 parent_t::rng_sclr(mem->grid_size[0])
-              )));
+              ), "khn_tmp"));
 
           // courant field
           alloc_tmp_sclr(mem, __FILE__, 1);
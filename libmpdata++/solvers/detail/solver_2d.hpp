@@ -32,7 +32,7 @@ namespace libmpdataxx
 
         protected:
 
-        const rng_t i, j; // TODO: to be removed
+        rng_t i, j; // TODO: to be removed
 
         // generic field used for various statistics (currently Courant number and divergence)
         typename parent_t::arr_t &stat_field; // TODO: should be in solver common but cannot be allocated there ?
@@ -43,6 +43,7 @@ namespace libmpdataxx
                         const bool deriv = false
         ) final // for a given array
         {
+          const auto region = this->timed_region("xchng_sclr");
           const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk[1]^ext, deriv);
@@ -50,13 +51,36 @@ namespace libmpdataxx
           this->mem->barrier();
         }
 
+        // halos of several arrays exchanged at once (single message per neighbour with remote bcond)
+        void xchng_sclr(const std::vector<typename parent_t::arr_t*> &arrs,
+                        const idx_t<2> &range_ijk,
+                        const int ext = 0,
+                        const bool deriv = false
+        )
+        {
+          const auto region = this->timed_region("xchng_sclr");
+          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
+          this->mem->barrier();
+          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr_batch(arrs, range_ijk[1]^ext, deriv);
+          for (auto &bc : this->bcs[1]) bc->fill_halos_sclr_batch(arrs, range_ijk_0__ext, deriv);
+          this->mem->barrier();
+        }
+
         void xchng(int e) final
         {
           this->xchng_sclr(this->mem->psi[e][ this->n[e]], this->ijk, this->halo);
         }
 
+        void xchng_batch(const std::vector<int> &es) final
+        {
+          std::vector<typename parent_t::arr_t*> arrs;
+          for (auto e : es) arrs.push_back(&this->mem->psi[e][ this->n[e]]);
+          this->xchng_sclr(arrs, this->ijk, this->halo);
+        }
+
         void xchng_vctr_alng(arrvec_t<typename parent_t::arr_t> &arrvec, const bool ad = false, const bool cyclic = false) final
         {
+          const auto region = this->timed_region("xchng_vctr_alng");
           this->mem->barrier();
           if (!cyclic)
           {
@@ -74,6 +98,7 @@ namespace libmpdataxx
 
         virtual void xchng_flux(arrvec_t<typename parent_t::arr_t> &arrvec) final
         {
+          const auto region = this->timed_region("xchng_flux");
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_flux(arrvec, j);
           for (auto &bc : this->bcs[1]) bc->fill_halos_flux(arrvec, i);
@@ -85,6 +110,7 @@ namespace libmpdataxx
           const idx_t<2> &range_ijk
         ) final
         {
+          const auto region = this->timed_region("xchng_sgs_div");
           this->mem->barrier();
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_div(arr, range_ijk[0]);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_div(arr, range_ijk[1]^h);
@@ -96,6 +122,7 @@ namespace libmpdataxx
                             const idx_t<2> &range_ijk
         ) final
         {
+          const auto region = this->timed_region("xchng_sgs_vctr");
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_vctr(av, b, range_ijk[1]);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_vctr(av, b, range_ijk[0]);
@@ -108,6 +135,7 @@ namespace libmpdataxx
                                          const idx_t<2> &range_ijk
         ) final
         {
+          const auto region = this->timed_region("xchng_sgs_tnsr_diag");
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[1], this->dijk[0]);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[0], this->dijk[1]);
@@ -120,6 +148,7 @@ namespace libmpdataxx
                                             const idx_t<2> &range_ijkm
         ) final
         {
+          const auto region = this->timed_region("xchng_sgs_tnsr_offdiag");
 
           // off-diagonal components of stress tensor are treated the same as a vector
           this->mem->barrier();
@@ -135,6 +164,7 @@ namespace libmpdataxx
           const bool cyclic = false
         ) final
         {
+          const auto region = this->timed_region("xchng_vctr_nrml");
 
           const auto range_ijk_0__ext_h = this->extend_range(range_ijk[0], ext, h);
           this->mem->barrier();
@@ -157,6 +187,7 @@ namespace libmpdataxx
           const int ext = 0
         ) final
         {
+          const auto region = this->timed_region("xchng_pres");
           const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk[1]^ext);
@@ -272,6 +303,13 @@ namespace libmpdataxx
           this->set_bcs(1, args.bcyl, args.bcyr);
         }
 
+        void set_ijk(const idx_t<2> &ijk_) override
+        {
+          parent_t::set_ijk(ijk_);
+          i = ijk_[0];
+          j = ijk_[1];
+        }
+
         // memory allocation logic using static methods
 
         public:
@@ -284,20 +322,20 @@ namespace libmpdataxx
           mem->psi.resize(parent_t::n_eqns);
           for (int e = 0; e < parent_t::n_eqns; ++e) // equations
             for (int n = 0; n < n_tlev; ++n) // time levels
-              mem->psi[e].push_back(mem->old(new typename parent_t::arr_t(
+              mem->psi[e].push_back(mem->old_shared("psi", __FILE__,
                 parent_t::rng_sclr(mem->grid_size[0]),
                 parent_t::rng_sclr(mem->grid_size[1])
-              )));
+              ));
 
           // Courant field components (Arakawa-C grid)
-          mem->GC.push_back(mem->old(new typename parent_t::arr_t(
+          mem->GC.push_back(mem->old_shared("GC", __FILE__,
             parent_t::rng_vctr(mem->grid_size[0]),
             parent_t::rng_sclr(mem->grid_size[1])
-          )));
-          mem->GC.push_back(mem->old(new typename parent_t::arr_t(
+          ));
+          mem->GC.push_back(mem->old_shared("GC", __FILE__,
             parent_t::rng_sclr(mem->grid_size[0]),
             parent_t::rng_vctr(mem->grid_size[1])
-          )));
+          ));
 
           // fully third-order accurate mpdata needs also time derivatives of
           // the Courant field
@@ -305,38 +343,38 @@ namespace libmpdataxx
               opts::isset(ct_params_t::opts, opts::div_3rd_dt))
           {
             // TODO: why for (auto f : {mem->ndt_GC, mem->ndtt_GC}) doesn't work ?
-            mem->ndt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            mem->ndt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_vctr(mem->grid_size[0]),
               parent_t::rng_sclr(mem->grid_size[1])
-            )));
-            mem->ndt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            ), "ndt_GC"));
+            mem->ndt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_sclr(mem->grid_size[0]),
               parent_t::rng_vctr(mem->grid_size[1])
-            )));
-            mem->ndtt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            ), "ndt_GC"));
+            mem->ndtt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_vctr(mem->grid_size[0]),
               parent_t::rng_sclr(mem->grid_size[1])
-            )));
-            mem->ndtt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            ), "ndtt_GC"));
+            mem->ndtt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_sclr(mem->grid_size[0]),
               parent_t::rng_vctr(mem->grid_size[1])
-            )));
+            ), "ndtt_GC"));
           }
 
           // allocate G
           if (opts::isset(ct_params_t::opts, opts::nug))
-            mem->G.reset(mem->old(new typename parent_t::arr_t(
+            mem->G.reset(mem->old(mem->new_arr(
                     parent_t::rng_sclr(mem->grid_size[0]),
                     parent_t::rng_sclr(mem->grid_size[1])
-            )));
+            ), "G"));
 
           // allocate Kahan summation temporary vars
           if (opts::isset(ct_params_t::opts, opts::khn))
             for (int n = 0; n < 3; ++n)
-              mem->khn_tmp.push_back(mem->old(new typename parent_t::arr_t(
+              mem->khn_tmp.push_back(mem->old(mem->new_arr(
                 parent_t::rng_sclr(mem->grid_size[0]),
                 parent_t::rng_sclr(mem->grid_size[1])
-              )));
+              ), "khn_tmp"));
           // courant field
           alloc_tmp_sclr(mem, __FILE__, 1);
         }
@@ -355,12 +393,12 @@ namespace libmpdataxx
           mem->tmp[__file__].push_back(new arrvec_t<typename parent_t::arr_t>());
           for (int n = 0; n < n_arr; ++n)
           {
-            mem->tmp[__file__].back().push_back(mem->old(new typename parent_t::arr_t(
+            mem->tmp[__file__].back().push_back(mem->old(mem->new_arr(
               stgr[n][0] ? parent_t::rng_vctr(mem->grid_size[0]) : parent_t::rng_sclr(mem->grid_size[0]),
               srfc ? rng_t(0, 0) :
                 stgr[n][1] ? parent_t::rng_vctr(mem->grid_size[1]) :
                   parent_t::rng_sclr(mem->grid_size[1])
-            )));
+            ), "tmp", __file__));
           }
         }
 
@@ -386,10 +424,10 @@ namespace libmpdataxx
           if (!name.empty()) mem->avail_tmp[name] = std::make_pair(__file__, mem->tmp[__file__].size() - 1);
 
           for (int n = 0; n < n_arr; ++n)
-            mem->tmp[__file__].back().push_back(mem->old(new typename parent_t::arr_t(
+            mem->tmp[__file__].back().push_back(mem->old(mem->new_arr(
               parent_t::rng_sclr(mem->grid_size[0]),
               srfc ? rng_t(0, 0) : parent_t::rng_sclr(mem->grid_size[1])
-            )));
+            ), name.empty() ? "tmp" : name.c_str(), __file__));
         }
       };
     } // namespace detail
@@ -32,7 +32,7 @@ namespace libmpdataxx
 
         protected:
 
-        const rng_t i, j, k; // TODO: we have ijk in solver_common - could it be removed?
+        rng_t i, j, k; // TODO: we have ijk in solver_common - could it be removed?
 
         // generic field used for various statistics (currently Courant number and divergence)
         typename parent_t::arr_t &stat_field; // TODO:/: should be in solver common but cannot be allocated there ?
@@ -43,6 +43,7 @@ namespace libmpdataxx
                        const bool deriv = false
         ) final // for a given array
         {
+          const auto region = this->timed_region("xchng_sclr");
           const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk[1]^ext, range_ijk[2]^ext, deriv);
@@ -50,13 +51,37 @@ namespace libmpdataxx
           for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, range_ijk_0__ext, range_ijk[1]^ext, deriv);
           this->mem->barrier();
         }
+        // halos of several arrays exchanged at once (single message per neighbour with remote bcond)
+        void xchng_sclr(const std::vector<typename parent_t::arr_t*> &arrs,
+                        const idx_t<3> &range_ijk,
+                        const int ext = 0,
+                        const bool deriv = false
+        )
+        {
+          const auto region = this->timed_region("xchng_sclr");
+          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
+          this->mem->barrier();
+          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr_batch(arrs, range_ijk[1]^ext, range_ijk[2]^ext, deriv);
+          for (auto &bc : this->bcs[1]) bc->fill_halos_sclr_batch(arrs, range_ijk[2]^ext, range_ijk_0__ext, deriv);
+          for (auto &bc : this->bcs[2]) bc->fill_halos_sclr_batch(arrs, range_ijk_0__ext, range_ijk[1]^ext, deriv);
+          this->mem->barrier();
+        }
+
         void xchng(int e) final
         {
           this->xchng_sclr(this->mem->psi[e][ this->n[e]], this->ijk, this->halo);
         }
 
+        void xchng_batch(const std::vector<int> &es) final
+        {
+          std::vector<typename parent_t::arr_t*> arrs;
+          for (auto e : es) arrs.push_back(&this->mem->psi[e][ this->n[e]]);
+          this->xchng_sclr(arrs, this->ijk, this->halo);
+        }
+
         void xchng_vctr_alng(arrvec_t<typename parent_t::arr_t> &arrvec, const bool ad = false, const bool cyclic = false) final
         {
+          const auto region = this->timed_region("xchng_vctr_alng");
           this->mem->barrier();
           if (!cyclic)
           {
@@ -75,6 +100,7 @@ namespace libmpdataxx
 
         virtual void xchng_flux(arrvec_t<typename parent_t::arr_t> &arrvec) final
         {
+          const auto region = this->timed_region("xchng_flux");
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_flux(arrvec, j, k);
           for (auto &bc : this->bcs[1]) bc->fill_halos_flux(arrvec, k, i);
@@ -86,6 +112,7 @@ namespace libmpdataxx
           const idx_t<3> &range_ijk
         ) final
         {
+          const auto region = this->timed_region("xchng_sgs_div");
           this->mem->barrier();
           for (auto &bc : this->bcs[2]) bc->fill_halos_sgs_div(arr, range_ijk[0], range_ijk[1]);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_div(arr, range_ijk[2]^h, range_ijk[0]);
@@ -98,6 +125,7 @@ namespace libmpdataxx
                                     const idx_t<3> &range_ijk
         ) final
         {
+          const auto region = this->timed_region("xchng_sgs_vctr");
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_vctr(av, b, range_ijk[1], range_ijk[2]);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_vctr(av, b, range_ijk[2], range_ijk[0]);
@@ -111,6 +139,7 @@ namespace libmpdataxx
                                          const idx_t<3> &range_ijk
         ) final
         {
+          const auto region = this->timed_region("xchng_sgs_tnsr_diag");
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[1], range_ijk[2], this->dijk[0]);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[2], range_ijk[0], this->dijk[1]);
@@ -124,6 +153,7 @@ namespace libmpdataxx
                                             const idx_t<3> &range_ijkm
         ) final
         {
+          const auto region = this->timed_region("xchng_sgs_tnsr_offdiag");
           // off-diagonal components of stress tensor are treated the same as a vector
           this->mem->barrier();
           for (auto &bc : this->bcs[0])
@@ -153,6 +183,7 @@ namespace libmpdataxx
           const bool cyclic = false
         ) final
         {
+          const auto region = this->timed_region("xchng_vctr_nrml");
           this->mem->barrier();
           const auto range_ijk_0__ext_h = this->extend_range(range_ijk[0], ext, h);
           const auto range_ijk_0__ext_1 = this->extend_range(range_ijk[0], ext, 1);
@@ -197,6 +228,7 @@ namespace libmpdataxx
           const int ext = 0
         ) final
         {
+          const auto region = this->timed_region("xchng_pres");
           const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk[1]^ext, range_ijk[2]^ext);
@@ -323,6 +355,14 @@ namespace libmpdataxx
           this->set_bcs(2, args.bczl, args.bczr);
         }
 
+        void set_ijk(const idx_t<3> &ijk_) override
+        {
+          parent_t::set_ijk(ijk_);
+          i = ijk_[0];
+          j = ijk_[1];
+          k = ijk_[2];
+        }
+
         public:
 
         static void alloc(
@@ -334,28 +374,28 @@ namespace libmpdataxx
           mem->psi.resize(parent_t::n_eqns);
           for (int e = 0; e < parent_t::n_eqns; ++e) // equations
             for (int n = 0; n < n_tlev; ++n) // time levels
-              mem->psi[e].push_back(mem->old(new typename parent_t::arr_t(
+              mem->psi[e].push_back(mem->old_shared("psi", __FILE__,
                 parent_t::rng_sclr(mem->grid_size[0]),
                 parent_t::rng_sclr(mem->grid_size[1]),
                 parent_t::rng_sclr(mem->grid_size[2])
-              )));
+              ));
 
           // Courant field components (Arakawa-C grid)
-          mem->GC.push_back(mem->old(new typename parent_t::arr_t(
+          mem->GC.push_back(mem->old_shared("GC", __FILE__,
             parent_t::rng_vctr(mem->grid_size[0]),
             parent_t::rng_sclr(mem->grid_size[1]),
             parent_t::rng_sclr(mem->grid_size[2])
-          )));
-          mem->GC.push_back(mem->old(new typename parent_t::arr_t(
+          ));
+          mem->GC.push_back(mem->old_shared("GC", __FILE__,
             parent_t::rng_sclr(mem->grid_size[0]),
             parent_t::rng_vctr(mem->grid_size[1]),
             parent_t::rng_sclr(mem->grid_size[2])
-          )));
-          mem->GC.push_back(mem->old(new typename parent_t::arr_t(
+          ));
+          mem->GC.push_back(mem->old_shared("GC", __FILE__,
             parent_t::rng_sclr(mem->grid_size[0]),
             parent_t::rng_sclr(mem->grid_size[1]),
             parent_t::rng_vctr(mem->grid_size[2])
-          )));
+          ));
 
           // fully third-order accurate mpdata needs also time derivatives of
           // the Courant field
@@ -363,55 +403,55 @@ namespace libmpdataxx
               opts::isset(ct_params_t::opts, opts::div_3rd_dt))
           {
             // TODO: why for (auto f : {mem->ndt_GC, mem->ndtt_GC}) doesn't work ?
-            mem->ndt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            mem->ndt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_vctr(mem->grid_size[0]),
               parent_t::rng_sclr(mem->grid_size[1]),
               parent_t::rng_sclr(mem->grid_size[2])
-            )));
-            mem->ndt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            ), "ndt_GC"));
+            mem->ndt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_sclr(mem->grid_size[0]),
               parent_t::rng_vctr(mem->grid_size[1]),
               parent_t::rng_sclr(mem->grid_size[2])
-            )));
-            mem->ndt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            ), "ndt_GC"));
+            mem->ndt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_sclr(mem->grid_size[0]),
               parent_t::rng_sclr(mem->grid_size[1]),
               parent_t::rng_vctr(mem->grid_size[2])
-            )));
+            ), "ndt_GC"));
 
-            mem->ndtt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            mem->ndtt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_vctr(mem->grid_size[0]),
               parent_t::rng_sclr(mem->grid_size[1]),
               parent_t::rng_sclr(mem->grid_size[2])
-            )));
-            mem->ndtt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            ), "ndtt_GC"));
+            mem->ndtt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_sclr(mem->grid_size[0]),
               parent_t::rng_vctr(mem->grid_size[1]),
               parent_t::rng_sclr(mem->grid_size[2])
-            )));
-            mem->ndtt_GC.push_back(mem->old(new typename parent_t::arr_t(
+            ), "ndtt_GC"));
+            mem->ndtt_GC.push_back(mem->old(mem->new_arr(
               parent_t::rng_sclr(mem->grid_size[0]),
               parent_t::rng_sclr(mem->grid_size[1]),
               parent_t::rng_vctr(mem->grid_size[2])
-            )));
+            ), "ndtt_GC"));
           }
 
           // allocate G
           if (opts::isset(ct_params_t::opts, opts::nug))
-            mem->G.reset(mem->old(new typename parent_t::arr_t(
+            mem->G.reset(mem->old(mem->new_arr(
                     parent_t::rng_sclr(mem->grid_size[0]),
                     parent_t::rng_sclr(mem->grid_size[1]),
                     parent_t::rng_sclr(mem->grid_size[2])
-            )));
+            ), "G"));
 
           // allocate Kahan summation temporary vars
           if (opts::isset(ct_params_t::opts, opts::khn))
             for (int n = 0; n < 3; ++n)
-              mem->khn_tmp.push_back(mem->old(new typename parent_t::arr_t(
+              mem->khn_tmp.push_back(mem->old(mem->new_arr(
                 parent_t::rng_sclr(mem->grid_size[0]),
                 parent_t::rng_sclr(mem->grid_size[1]),
                 parent_t::rng_sclr(mem->grid_size[2])
-              )));
+              ), "khn_tmp"));
           // courant field
           alloc_tmp_sclr(mem, __FILE__, 1);
         }
@@ -428,13 +468,13 @@ namespace libmpdataxx
           mem->tmp[__file__].push_back(new arrvec_t<typename parent_t::arr_t>());
           for (int n = 0; n < n_arr; ++n)
           {
-            mem->tmp[__file__].back().push_back(mem->old(new typename parent_t::arr_t(
+            mem->tmp[__file__].back().push_back(mem->old(mem->new_arr(
               stgr[n][0] ? parent_t::rng_vctr(mem->grid_size[0]) : parent_t::rng_sclr(mem->grid_size[0]),
               stgr[n][1] ? parent_t::rng_vctr(mem->grid_size[1]) : parent_t::rng_sclr(mem->grid_size[1]),
               srfc ? rng_t(0, 0) :
                 stgr[n][2] ? parent_t::rng_vctr(mem->grid_size[2]) :
                   parent_t::rng_sclr(mem->grid_size[2])
-            )));
+            ), "tmp", __file__));
           }
         }
 
@@ -460,11 +500,11 @@ namespace libmpdataxx
           if (!name.empty()) mem->avail_tmp[name] = std::make_pair(__file__, mem->tmp[__file__].size() - 1);
 
           for (int n = 0; n < n_arr; ++n)
-            mem->tmp[__file__].back().push_back(mem->old(new typename parent_t::arr_t(
+            mem->tmp[__file__].back().push_back(mem->old(mem->new_arr(
               parent_t::rng_sclr(mem->grid_size[0]),
               parent_t::rng_sclr(mem->grid_size[1]),
               srfc ? rng_t(0, 0) : parent_t::rng_sclr(mem->grid_size[2])
-            )));
+            ), name.empty() ? "tmp" : name.c_str(), __file__));
         }
       };
     } // namespace detail
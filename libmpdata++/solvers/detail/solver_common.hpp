@@ -9,12 +9,16 @@
 #include <libmpdata++/blitz.hpp>
 #include <libmpdata++/formulae/arakawa_c.hpp>
 #include <libmpdata++/concurr/detail/sharedmem.hpp>
+#include <libmpdata++/concurr/detail/phase_timers.hpp>
 
 #include <libmpdata++/solvers/detail/monitor.hpp>
 
 #include <libmpdata++/bcond/detail/bcond_common.hpp>
 
 #include <array>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace libmpdataxx
 {
@@ -66,15 +70,27 @@ namespace libmpdataxx
         std::array<real_t, div3_mpdata ? 2 : 1> dt_stash;
         std::array<real_t, n_dims> dijk;
 
-        const idx_t<n_dims> ijk;
+        idx_t<n_dims> ijk; // not const as may be changed by slab rebalancing (see set_ijk)
 
         long long int timestep = 0;
         real_t time = 0;
         std::vector<int> n;
+        bool restarted = false; // set by restart(), reset by the first solve() afterwards
 
         typedef concurr::detail::sharedmem<real_t, n_dims, n_tlev> mem_t;
         mem_t *mem;
 
+        // per-thread, used only if ct_params_t::phase_timers is set
+        concurr::detail::phase_timers phase_tmrs;
+
+        // to be kept in scope for the duration of the timed region, e.g.:
+        // const auto region = this->timed_region("advop", e);
+        // (arg is shown in the timeline only, see rt_params_t::trace_path)
+        concurr::detail::phase_scope<bool(ct_params_t::phase_timers), bool(ct_params_t::tracing)> timed_region(const char *name, const int arg = -1)
+        {
+          return {phase_tmrs, name, ct_params_t::tracing ? mem->trace.get() : nullptr, arg};
+        }
+
         // helper methods invoked by solve()
         virtual void advop(int e) = 0;
 
@@ -95,6 +111,7 @@ namespace libmpdataxx
         }
 
         virtual void xchng(int e) = 0;
+        virtual void xchng_batch(const std::vector<int> &es) = 0; // halos of several equations at once
         // TODO: implement flagging of valid/invalid halo for optimisations
 
         virtual void xchng_vctr_alng(arrvec_t<arr_t>&, const bool ad = false, const bool cyclic = false) = 0;
@@ -104,7 +121,8 @@ namespace libmpdataxx
           // with distributed memory and cyclic boundary conditions,
           // leftmost node must send left first, as
           // rightmost node is waiting
-          if (d == 0 && this->mem->distmem.size() > 0 && this->mem->distmem.rank() == 0)
+          // (the same applies to other dimensions if divided among processes)
+          if ((d == 0 || this->mem->distmem.dims[d] > 1) && this->mem->distmem.coords[d] == 0)
             std::swap(bcl, bcr);
 
           bcs[d][0] = std::move(bcl);
@@ -122,15 +140,37 @@ namespace libmpdataxx
 
         virtual void scale_gc(const real_t time, const real_t cur_dt, const real_t prev_dt) = 0;
 
-        void solve_loop_body(const int e)
+        // advancing all equations with (delayed == true) or without delayed step,
+        // halos of all of them are exchanged before the first advop (one message per neighbour with remote bcond)
+        void solve_loop_body(const bool delayed)
         {
-          scale(e, ct_params_t::hint_scale(e));
-          xchng(e);
-          advop(e);
-          if(!is_last_eqn(e))
-            mem->barrier();
-          cycle(e);  // note: assuming ascending order, mem->cycle is done after the lest eqn
-          scale(e, -ct_params_t::hint_scale(e));
+          std::vector<int> es;
+          for (int e = 0; e < n_eqns; ++e)
+            if (opts::isset(ct_params_t::delayed_step, opts::bit(e)) == delayed) es.push_back(e);
+          if (es.empty()) return;
+
+          const auto region = timed_region("solve_loop_body");
+
+          for (auto e : es) scale(e, ct_params_t::hint_scale(e));
+          xchng_batch(es);
+          for (auto e : es)
+          {
+            {
+              const auto region_e = timed_region("advop", e);
+              advop(e);
+            }
+            if(!is_last_eqn(e))
+              mem->barrier();
+            cycle(e);  // note: assuming ascending order, mem->cycle is done after the lest eqn
+            scale(e, -ct_params_t::hint_scale(e));
+          }
+        }
+
+        // called between advance() calls if the thread subdomains are changed, solvers storing
+        // ranges derived from ijk need to override it
+        virtual void set_ijk(const idx_t<n_dims> &ijk_)
+        {
+          ijk = ijk_;
         }
 
         // thread-aware range extension
@@ -186,6 +226,11 @@ namespace libmpdataxx
 #endif
         }
 
+        // called instead of hook_ante_loop() by the first solve() after restart(),
+        // redoes the setup that is not a part of the checkpointed state (e.g. fields derived from the parameters)
+        virtual void hook_ante_restart(const advance_arg_t nt)
+        {}
+
         virtual void hook_ante_loop(const advance_arg_t nt)
         {
 #if !defined(NDEBUG)
@@ -211,10 +256,67 @@ namespace libmpdataxx
         public:
 
         const real_t time_() const { return time;}
+        const long long int timestep_() const { return timestep;}
+
+        // full-state checkpointing, implemented in output::hdf5
+        virtual void checkpoint(const std::string &path)
+        {
+          throw std::runtime_error("checkpointing requires HDF5 output (output::hdf5)");
+        }
+
+        virtual void restart(const std::string &path)
+        {
+          throw std::runtime_error("restarting requires HDF5 output (output::hdf5)");
+        }
+
+        // time and number of calls of each timed region of this thread (see timed_region)
+        std::map<std::string, std::pair<double, long long>> phase_results() const
+        {
+          return phase_tmrs.results();
+        }
+
+        // hardware counts of each timed region of this thread, and why they are not available if so
+        std::map<std::string, concurr::detail::hw_counts_t> hw_results() const
+        {
+          return phase_tmrs.hw_results();
+        }
+
+        const std::string &hw_error() const
+        {
+          return phase_tmrs.hw_state().error();
+        }
+
+        // changes the range of the thread subdomain in the first dimension (see concurr_common::rebalance)
+        void set_slab(const rng_t &i)
+        {
+          auto ijk_ = ijk;
+          ijk_.lbound()(0) = i.first();
+          ijk_.ubound()(0) = i.last();
+          set_ijk(ijk_);
+        }
+
+        // used after restart() to set the clock of all threads
+        void copy_clock(const solver_common &o)
+        {
+          timestep = o.timestep;
+          time = o.time;
+          dt = o.dt;
+          dt_stash = o.dt_stash;
+          n = o.n;
+          restarted = o.restarted;
+        }
 
         struct rt_params_t
         {
           std::array<int, n_dims> grid_size;
+          std::array<int, n_dims> mpi_dims = concurr::detail::default_mpi_dims<n_dims>(); // MPI process grid, zeros are chosen by MPI_Dims_create
+          bool mpi_comm_thread = false; // if true, MPI is called by a dedicated thread only (MPI_THREAD_SERIALIZED suffices)
+          bool mpi_persistent = false; // if true, remote halos are exchanged without packing, with subarray datatypes and persistent requests
+          bool slab_rebalance = false; // if true, thread subdomains are resized between advance() calls to even out their compute times
+          bool barrier_profile = false; // if true, waiting at each call site of barrier() is recorded (see concurr::any::barrier_profile)
+          bool hw_counters = false; // if true, hardware counters are read at the boundaries of the timed regions (Linux only, requires ct_params_t::phase_timers, see concurr::any::hw_counts)
+          bool memory_report = false; // if true, the memory used by the arrays is printed after allocation, and the peak memory use at exit (see concurr::any::memory_usage)
+          std::string trace_path = ""; // if not empty, a timeline of the run is written there at exit (Chrome trace-event JSON, requires ct_params_t::tracing)
           real_t dt=0, max_abs_div_eps = blitz::epsilon(real_t(44)), max_courant = real_t(0.5);
         };
 
@@ -241,6 +343,10 @@ namespace libmpdataxx
           static_assert(n_eqns > 0, "!");
 
           // run-time sanity checks
+          if (p.hw_counters && !ct_params_t::phase_timers)
+            throw std::runtime_error("hw_counters requires ct_params_t::phase_timers");
+          phase_tmrs.count_hw(p.hw_counters);
+
           for (int d = 0; d < n_dims; ++d)
             if (p.grid_size[d] < 1)
               throw std::runtime_error("bogus grid size");
@@ -271,6 +377,11 @@ namespace libmpdataxx
           // TODO: does it really work with var_dt ? we do not advance by time exactly ...
           nt += ct_params_t::var_dt ? time : timestep;
 
+          mem_t::thread_rank() = rank;
+
+          // counting the events of the thread running this solve()
+          phase_tmrs.hw_start();
+
           // being generous about out-of-loop barriers
           if (timestep == 0)
           {
@@ -281,6 +392,13 @@ namespace libmpdataxx
             hook_ante_loop(nt);
             mem->barrier();
           }
+          else if (restarted)
+          {
+            mem->barrier();
+            hook_ante_restart(nt);
+            restarted = false;
+            mem->barrier();
+          }
 
           // moved here so that if an exception is thrown from hook_ante_loop these do not cause complaints
 #if !defined(NDEBUG)
@@ -328,19 +446,11 @@ namespace libmpdataxx
 
             hook_ante_step();
 
-            for (int e = 0; e < n_eqns; ++e)
-            {
-              if (opts::isset(ct_params_t::delayed_step, opts::bit(e))) continue;
-              solve_loop_body(e);
-            }
+            solve_loop_body(false);
 
             hook_ante_delayed_step();
 
-            for (int e = 0; e < n_eqns; ++e)
-            {
-              if (!opts::isset(ct_params_t::delayed_step, opts::bit(e))) continue;
-              solve_loop_body(e);
-            }
+            solve_loop_body(true);
 
             timestep++;
             time = ct_params_t::var_dt ? time + dt : timestep * dt;
@@ -352,6 +462,7 @@ namespace libmpdataxx
           }
 
           mem->barrier();
+          phase_tmrs.hw_stop();
           // note: hook_post_loop was removed as conficling with multiple-advance()-call logic
         }
 
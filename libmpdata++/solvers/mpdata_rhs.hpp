@@ -71,7 +71,9 @@ namespace libmpdataxx
         }
 
         // fill halos with data (e.g. for computing gradients)
-        for (int e = 0; e < parent_t::n_eqns; ++e) this->xchng(e);
+        std::vector<int> es(parent_t::n_eqns);
+        std::iota(es.begin(), es.end(), 0);
+        this->xchng_batch(es);
       }
 
       virtual void apply_rhs(
@@ -201,6 +203,7 @@ namespace libmpdataxx
         // TODO: optimise to skip allocs for equations with no rhs
         parent_t::alloc(mem, n_iters);
         parent_t::alloc_tmp_sclr(mem, __FILE__, parent_t::n_eqns); // rhs array for each equation
+        mem->ckpt_tmp["rhs"] = std::make_pair(__FILE__, mem->tmp[__FILE__].size() - 1); // carried over to the next step by trapez and mixed schemes
       }
     };
   } // namespace solvers
@@ -34,7 +34,13 @@ namespace libmpdataxx
       using parent_t = detail::mpdata_rhs_vip_common<ct_params_t, minhalo>;
 
       // member fields
-      const rng_t im;
+      rng_t im;
+
+      void set_ijk(const idx_t<1> &ijk_) override
+      {
+        parent_t::set_ijk(ijk_);
+        im = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
+      }
 
       void interpolate_in_space(arrvec_t<typename parent_t::arr_t> &dst,
                                 const arrvec_t<typename parent_t::arr_t> &src) final
@@ -93,7 +99,14 @@ namespace libmpdataxx
       using parent_t = detail::mpdata_rhs_vip_common<ct_params_t, minhalo>;
 
       // member fields
-      const rng_t im, jm;
+      rng_t im, jm;
+
+      void set_ijk(const idx_t<2> &ijk_) override
+      {
+        parent_t::set_ijk(ijk_);
+        im = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
+        jm = rng_t(this->ijk[1].first() - 1, this->ijk[1].last());
+      }
 
       template<int d, class arr_t>
       void intrp(
@@ -174,16 +187,16 @@ namespace libmpdataxx
         // allocate velocity absorber
         if (static_cast<vip_vab_t>(ct_params_t::vip_vab) != 0)
         {
-          mem->vab_coeff.reset(mem->old(new typename parent_t::arr_t(
+          mem->vab_coeff.reset(mem->old(mem->new_arr(
                   parent_t::rng_sclr(mem->grid_size[0]),
                   parent_t::rng_sclr(mem->grid_size[1])
-          )));
+          ), "vab_coeff"));
 
           for (int n = 0; n < ct_params_t::n_dims; ++n)
-            mem->vab_relax.push_back(mem->old(new typename parent_t::arr_t(
+            mem->vab_relax.push_back(mem->old(mem->new_arr(
                     parent_t::rng_sclr(mem->grid_size[0]),
                     parent_t::rng_sclr(mem->grid_size[1])
-            )));
+            ), "vab_relax"));
         }
       }
     };
@@ -203,7 +216,15 @@ namespace libmpdataxx
       using parent_t = detail::mpdata_rhs_vip_common<ct_params_t, minhalo>;
 
       // member fields
-      const rng_t im, jm, km;
+      rng_t im, jm, km;
+
+      void set_ijk(const idx_t<3> &ijk_) override
+      {
+        parent_t::set_ijk(ijk_);
+        im = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
+        jm = rng_t(this->ijk[1].first() - 1, this->ijk[1].last());
+        km = rng_t(this->ijk[2].first() - 1, this->ijk[2].last());
+      }
 
       template<int d, class arr_t>
       void intrp(
@@ -274,18 +295,18 @@ namespace libmpdataxx
         // allocate velocity absorber
         if (static_cast<vip_vab_t>(ct_params_t::vip_vab) != 0)
         {
-          mem->vab_coeff.reset(mem->old(new typename parent_t::arr_t(
+          mem->vab_coeff.reset(mem->old(mem->new_arr(
                   parent_t::rng_sclr(mem->grid_size[0]),
                   parent_t::rng_sclr(mem->grid_size[1]),
                   parent_t::rng_sclr(mem->grid_size[2])
-          )));
+          ), "vab_coeff"));
 
           for (int n = 0; n < ct_params_t::n_dims; ++n)
-            mem->vab_relax.push_back(mem->old(new typename parent_t::arr_t(
+            mem->vab_relax.push_back(mem->old(mem->new_arr(
                     parent_t::rng_sclr(mem->grid_size[0]),
                     parent_t::rng_sclr(mem->grid_size[1]),
                     parent_t::rng_sclr(mem->grid_size[2])
-            )));
+            ), "vab_relax"));
         }
       }
 
@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief a minimal registry of benchmark cases run either with Google Benchmark
+ *   (if LIBMPDATAXX_GBENCH is defined, see CMakeLists.txt) or with a simple timer loop;
+ *   each case reports the number of grid cells processed per second and the effective
+ *   bandwidth, i.e. the size of all the arrays read and written divided by the time
+ *
+ * fallback timer loop usage: <bench> [--csv] [--min_time=<seconds>] [substring of the case names]
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(LIBMPDATAXX_GBENCH)
+#  include <benchmark/benchmark.h>
+#endif
+
+namespace bench
+{
+  struct case_t
+  {
+    std::string name;
+    double cells, bytes; // per call
+    std::function<std::function<void()>()> make; // allocating the arrays and returning the timed function
+  };
+
+  inline std::vector<case_t> &cases()
+  {
+    static std::vector<case_t> res;
+    return res;
+  }
+
+  // n_arrs: number of arrays (of the size of the computational domain) read or written by the timed function
+  template <typename real_t>
+  void add(const std::string &name, const double cells, const int n_arrs, const std::function<std::function<void()>()> &make)
+  {
+    cases().push_back({name, cells, cells * n_arrs * sizeof(real_t), make});
+  }
+
+#if defined(LIBMPDATAXX_GBENCH)
+  inline int run(int argc, char **argv)
+  {
+    for (const auto &c : cases())
+    {
+      benchmark::RegisterBenchmark(c.name.c_str(), [c](benchmark::State &st) {
+        const auto fun = c.make();
+        for (auto _ : st) fun();
+        st.counters["cells/s"] = benchmark::Counter(c.cells, benchmark::Counter::kIsIterationInvariantRate);
+        st.SetBytesProcessed(int64_t(st.iterations() * c.bytes));
+      });
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+  }
+#else
+  inline int run(int argc, char **argv)
+  {
+    using clock_t = std::chrono::steady_clock;
+
+    bool csv = false;
+    double min_time = .2;
+    std::string filter;
+    for (int a = 1; a < argc; ++a)
+    {
+      const std::string arg = argv[a];
+      if (arg == "--csv") csv = true;
+      else if (arg.find("--min_time=") == 0) min_time = std::stod(arg.substr(11));
+      else filter = arg;
+    }
+
+    if (csv) std::printf("name,time_ns,cells_per_s,bytes_per_s\n");
+    else std::printf("%-56s %14s %14s %10s\n", "case", "time [ns]", "Mcells/s", "GB/s");
+
+    for (const auto &c : cases())
+    {
+      if (c.name.find(filter) == std::string::npos) continue;
+      const auto fun = c.make();
+
+      auto time = [&](const long n) {
+        const auto t0 = clock_t::now();
+        for (long r = 0; r < n; ++r) fun();
+        return std::chrono::duration<double>(clock_t::now() - t0).count();
+      };
+
+      // warm-up and calibration of the number of calls per sample
+      long n = 1;
+      for (double t = time(n); t < min_time / 5; t = time(n)) n *= 2;
+
+      // the fastest of 5 samples
+      double best = time(n) / n;
+      for (int s = 1; s < 5; ++s) best = std::min(best, time(n) / n);
+
+      if (csv) std::printf("%s,%g,%g,%g\n", c.name.c_str(), best * 1e9, c.cells / best, c.bytes / best);
+      else std::printf("%-56s %14.0f %14.1f %10.2f\n", c.name.c_str(), best * 1e9, c.cells / best * 1e-6, c.bytes / best * 1e-9);
+      std::fflush(stdout);
+    }
+    return 0;
+  }
+#endif
+} // namespace bench
@@ -0,0 +1,466 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief microbenchmarks of the formulae kernels (antidiffusive velocities, donor-cell fluxes and sums,
+ *   FCT limiters, gradient, divergence and stress tensor) for a range of grid sizes and options,
+ *   called with the same arguments as in the solvers, on a single thread and with no halo exchanges
+ *
+ * the effective bandwidth assumes each array read or written by the kernel is transferred once
+ */
+
+#include <libmpdata++/formulae/mpdata/formulae_mpdata_1d.hpp>
+#include <libmpdata++/formulae/mpdata/formulae_mpdata_2d.hpp>
+#include <libmpdata++/formulae/mpdata/formulae_mpdata_3d.hpp>
+#include <libmpdata++/formulae/mpdata/formulae_mpdata_fct_1d.hpp>
+#include <libmpdata++/formulae/mpdata/formulae_mpdata_fct_2d.hpp>
+#include <libmpdata++/formulae/mpdata/formulae_mpdata_fct_3d.hpp>
+#include <libmpdata++/formulae/donorcell_formulae.hpp>
+#include <libmpdata++/formulae/nabla_formulae.hpp>
+#include <libmpdata++/formulae/stress_formulae.hpp>
+#include <libmpdata++/opts.hpp>
+
+#include "../bench.hpp"
+
+#include <cmath>
+#include <memory>
+
+using namespace libmpdataxx;
+using namespace libmpdataxx::arakawa_c;
+using opts::opts_t;
+
+using real_t = double;
+
+namespace
+{
+  const int halo = 3; // enough for all the stencils below
+
+  template <int n_dims> using arr_t = blitz::Array<real_t, n_dims>;
+  template <int n_dims> using vec_t = std::shared_ptr<arrvec_t<arr_t<n_dims>>>;
+
+  // deterministic pseudo-random values from [lo, hi]
+  template <int n_dims>
+  void fill(arr_t<n_dims> &a, const real_t lo, const real_t hi)
+  {
+    unsigned long long s = 12345;
+    for (auto it = a.begin(); it != a.end(); ++it)
+    {
+      s = s * 6364136223846793005ull + 1442695040888963407ull;
+      *it = lo + (hi - lo) * real_t(s >> 11) / real_t(1ull << 53);
+    }
+  }
+
+  // n^n_dims cells plus the halo, scalars are positive...
+  template <int n_dims>
+  arr_t<n_dims> scl(const int n, const real_t lo = 1, const real_t hi = 2)
+  {
+    arr_t<n_dims> a(blitz::TinyVector<int, n_dims>(-halo), blitz::TinyVector<int, n_dims>(n + 2 * halo));
+    fill(a, lo, hi);
+    return a;
+  }
+
+  // ... and vectors (Courant numbers, velocities, fluxes) of both signs
+  template <int n_dims>
+  vec_t<n_dims> vec(const int n_comps, const int n, const real_t lo = -.3, const real_t hi = .3)
+  {
+    vec_t<n_dims> v(new arrvec_t<arr_t<n_dims>>());
+    for (int c = 0; c < n_comps; ++c)
+    {
+      v->push_back(new arr_t<n_dims>(blitz::TinyVector<int, n_dims>(-halo), blitz::TinyVector<int, n_dims>(n + 2 * halo)));
+      fill((*v)[c], lo, hi);
+    }
+    return v;
+  }
+
+  template <int n_dims>
+  std::string name(const std::string &kernel, const opts_t o, const int n)
+  {
+    return kernel + "_" + std::to_string(n_dims) + "d/" + opts::opts_string(o) + "/" + std::to_string(n);
+  }
+
+  // cases are allocated only when run
+  template <int n_dims>
+  void add(const std::string &kernel, const opts_t o, const int n, const int n_arrs, const std::function<std::function<void()>()> &make)
+  {
+    bench::add<real_t>(name<n_dims>(kernel, o, n), std::pow(double(n), n_dims), n_arrs, make);
+  }
+
+  // number of arrays read or written by antidiff() in all dimensions
+  constexpr int antidiff_arrs(const opts_t o, const int n_dims)
+  {
+    return 1 + 2 * n_dims
+      + (opts::isset(o, opts::tot) && n_dims > 1 ? 1 : 0)
+      + (opts::isset(o, opts::div_3rd) ? 2 * n_dims : 0);
+  }
+
+  template <int n_dims> struct kernels;
+
+  template <>
+  struct kernels<1>
+  {
+    template <opts_t opts>
+    static void antidiff(const int n)
+    {
+      add<1>("antidiff", opts, n, antidiff_arrs(opts, 1), [n]{
+        auto psi = scl<1>(n), G = scl<1>(n);
+        auto GC = vec<1>(1, n), ndt_GC = vec<1>(1, n), ndtt_GC = vec<1>(1, n), res = vec<1>(1, n);
+        const rng_t im(-1, n - 1);
+        return [=]() mutable {
+          formulae::mpdata::antidiff<opts, solvers::exact, solvers::noextrp>((*res)[0], psi, *GC, *ndt_GC, *ndtt_GC, G, im);
+        };
+      });
+    }
+
+    template <opts_t opts>
+    static void donorcell(const int n)
+    {
+      add<1>("make_flux", opts, n, 3, [n]{
+        auto psi = scl<1>(n);
+        auto GC = vec<1>(1, n), flx = vec<1>(1, n);
+        const rng_t im(-1, n - 1);
+        return [=]() mutable {
+          (*flx)[0](im+h) = formulae::donorcell::make_flux<opts>(psi, (*GC)[0], im);
+        };
+      });
+
+      add<1>("donorcell_sum", opts, n, opts::isset(opts, opts::khn) ? 6 : 3, [n]{
+        auto psi = scl<1>(n), psi_new = scl<1>(n), G = scl<1>(n);
+        auto flx = vec<1>(1, n), khn_tmp = vec<1>(3, n);
+        const rng_t i(0, n - 1);
+        return [=]() mutable {
+          formulae::donorcell::donorcell_sum<opts>(
+            *khn_tmp, i, psi_new(i), psi(i),
+            (*flx)[0](i+h), (*flx)[0](i-h),
+            formulae::G<opts>(G, i)
+          );
+        };
+      });
+    }
+
+    template <opts_t opts>
+    static void fct(const int n)
+    {
+      add<1>("beta_up_dn", opts, n, 6, [n]{
+        auto psi = scl<1>(n), psi_max = scl<1>(n, 2, 3), psi_min = scl<1>(n, 0, 1), G = scl<1>(n);
+        auto flx = vec<1>(1, n), beta = vec<1>(2, n);
+        const rng_t i1(-1, n);
+        return [=]() mutable {
+          formulae::mpdata::beta_up<opts>((*beta)[0], psi, psi_max, *flx, G, i1);
+          formulae::mpdata::beta_dn<opts>((*beta)[1], psi, psi_min, *flx, G, i1);
+        };
+      });
+
+      add<1>("GC_mono", opts, n, 5, [n]{
+        auto psi = scl<1>(n), G = scl<1>(n);
+        auto beta = vec<1>(2, n, 0, 2), GC_corr = vec<1>(1, n), GC_mono = vec<1>(1, n);
+        const rng_t im(-1, n - 1);
+        return [=]() mutable {
+          formulae::mpdata::GC_mono<opts>((*GC_mono)[0], psi, (*beta)[0], (*beta)[1], (*GC_corr)[0], G, im);
+        };
+      });
+    }
+
+    // no 1D divergence, and the 1D calc_grad is not used by the solvers
+    static void nabla(const int) {}
+    static void stress(const int) {}
+  };
+
+  template <>
+  struct kernels<2>
+  {
+    template <opts_t opts>
+    static void antidiff(const int n)
+    {
+      add<2>("antidiff", opts, n, antidiff_arrs(opts, 2), [n]{
+        auto psi = scl<2>(n), psi_n = scl<2>(n), G = scl<2>(n);
+        auto GC = vec<2>(2, n), ndt_GC = vec<2>(2, n), ndtt_GC = vec<2>(2, n), res = vec<2>(2, n);
+        const rng_t i(0, n - 1), im(-1, n - 1);
+        return [=]() mutable {
+          formulae::mpdata::antidiff<opts, 0, solvers::exact, solvers::noextrp>((*res)[0], psi, psi_n, *GC, *ndt_GC, *ndtt_GC, G, im, i);
+          formulae::mpdata::antidiff<opts, 1, solvers::exact, solvers::noextrp>((*res)[1], psi, psi_n, *GC, *ndt_GC, *ndtt_GC, G, im, i);
+        };
+      });
+    }
+
+    template <opts_t opts>
+    static void donorcell(const int n)
+    {
+      add<2>("make_flux", opts, n, 5, [n]{
+        auto psi = scl<2>(n);
+        auto GC = vec<2>(2, n), flx = vec<2>(2, n);
+        const rng_t i(0, n - 1), im(-1, n - 1);
+        return [=]() mutable {
+          (*flx)[0](im+h, i) = formulae::donorcell::make_flux<opts, 0>(psi, (*GC)[0], im, i);
+          (*flx)[1](i, im+h) = formulae::donorcell::make_flux<opts, 1>(psi, (*GC)[1], im, i);
+        };
+      });
+
+      add<2>("donorcell_sum", opts, n, opts::isset(opts, opts::khn) ? 7 : 4, [n]{
+        auto psi = scl<2>(n), psi_new = scl<2>(n), G = scl<2>(n);
+        auto flx = vec<2>(2, n), khn_tmp = vec<2>(3, n);
+        const rng_t i(0, n - 1);
+        const idx_t<2> ijk({i, i});
+        return [=]() mutable {
+          formulae::donorcell::donorcell_sum<opts>(
+            *khn_tmp, ijk, psi_new(ijk), psi(ijk),
+            (*flx)[0](i+h, i  ), (*flx)[0](i-h, i  ),
+            (*flx)[1](i,   i+h), (*flx)[1](i,   i-h),
+            formulae::G<opts, 0>(G, i, i)
+          );
+        };
+      });
+    }
+
+    template <opts_t opts>
+    static void fct(const int n)
+    {
+      add<2>("beta_up_dn", opts, n, 7, [n]{
+        auto psi = scl<2>(n), psi_max = scl<2>(n, 2, 3), psi_min = scl<2>(n, 0, 1), G = scl<2>(n);
+        auto flx = vec<2>(2, n), beta = vec<2>(2, n);
+        const rng_t i1(-1, n);
+        return [=]() mutable {
+          formulae::mpdata::beta_up<opts>((*beta)[0], psi, psi_max, *flx, G, i1, i1);
+          formulae::mpdata::beta_dn<opts>((*beta)[1], psi, psi_min, *flx, G, i1, i1);
+        };
+      });
+
+      add<2>("GC_mono", opts, n, 7, [n]{
+        auto psi = scl<2>(n), G = scl<2>(n);
+        auto beta = vec<2>(2, n, 0, 2), GC_corr = vec<2>(2, n), GC_mono = vec<2>(2, n);
+        const rng_t i(0, n - 1), im(-1, n - 1);
+        return [=]() mutable {
+          formulae::mpdata::GC_mono<opts, 0>(*GC_mono, psi, (*beta)[0], (*beta)[1], *GC_corr, G, im, i);
+          formulae::mpdata::GC_mono<opts, 1>(*GC_mono, psi, (*beta)[0], (*beta)[1], *GC_corr, G, im, i);
+        };
+      });
+    }
+
+    static void nabla(const int n)
+    {
+      add<2>("calc_grad", 0, n, 3, [n]{
+        auto psi = scl<2>(n);
+        auto v = vec<2>(2, n);
+        const rng_t i(0, n - 1);
+        const idx_t<2> ijk({i, i});
+        const std::array<real_t, 2> dijk = {.1, .1};
+        return [=]() mutable {
+          formulae::nabla::calc_grad<2>(*v, psi, ijk, dijk);
+        };
+      });
+
+      add<2>("div", 0, n, 3, [n]{
+        auto div = scl<2>(n);
+        auto v = vec<2>(2, n);
+        const rng_t i(0, n - 1);
+        const idx_t<2> ijk({i, i});
+        const std::array<real_t, 2> dijk = {.1, .1};
+        return [=]() mutable {
+          div(ijk) = formulae::nabla::div<2>(*v, ijk, dijk);
+        };
+      });
+    }
+
+    static void stress(const int n)
+    {
+      add<2>("calc_vgrad", 0, n, 6, [n]{
+        auto v = vec<2>(2, n), vg = vec<2>(4, n);
+        const rng_t i(0, n - 1);
+        const idx_t<2> ijk({i, i});
+        const std::array<real_t, 2> dijk = {.1, .1};
+        return [=]() mutable {
+          formulae::stress::calc_vgrad<2>(*vg, *v, ijk, dijk);
+        };
+      });
+
+      add<2>("calc_deform", 0, n, 7, [n]{
+        auto vg = vec<2>(4, n), tau = vec<2>(3, n);
+        const rng_t i(0, n - 1);
+        const idx_t<2> ijk({i, i});
+        return [=]() mutable {
+          formulae::stress::calc_deform<2>(*tau, *vg, ijk);
+        };
+      });
+
+      add<2>("calc_stress_div", 0, n, 7, [n]{
+        auto tau = vec<2>(3, n), sdiv = vec<2>(4, n);
+        const rng_t i(0, n - 1);
+        const idx_t<2> ijk({i, i});
+        const std::array<real_t, 2> dijk = {.1, .1};
+        return [=]() mutable {
+          formulae::stress::calc_stress_div<2>(*sdiv, *tau, ijk, dijk);
+        };
+      });
+    }
+  };
+
+  template <>
+  struct kernels<3>
+  {
+    template <opts_t opts>
+    static void antidiff(const int n)
+    {
+      add<3>("antidiff", opts, n, antidiff_arrs(opts, 3), [n]{
+        auto psi = scl<3>(n), psi_n = scl<3>(n), G = scl<3>(n);
+        auto GC = vec<3>(3, n), ndt_GC = vec<3>(3, n), ndtt_GC = vec<3>(3, n), res = vec<3>(3, n);
+        const rng_t i(0, n - 1), im(-1, n - 1);
+        return [=]() mutable {
+          formulae::mpdata::antidiff<opts, 0, solvers::exact, solvers::noextrp>((*res)[0], psi, psi_n, *GC, *ndt_GC, *ndtt_GC, G, im, i, i);
+          formulae::mpdata::antidiff<opts, 1, solvers::exact, solvers::noextrp>((*res)[1], psi, psi_n, *GC, *ndt_GC, *ndtt_GC, G, im, i, i);
+          formulae::mpdata::antidiff<opts, 2, solvers::exact, solvers::noextrp>((*res)[2], psi, psi_n, *GC, *ndt_GC, *ndtt_GC, G, im, i, i);
+        };
+      });
+    }
+
+    template <opts_t opts>
+    static void donorcell(const int n)
+    {
+      add<3>("make_flux", opts, n, 7, [n]{
+        auto psi = scl<3>(n);
+        auto GC = vec<3>(3, n), flx = vec<3>(3, n);
+        const rng_t i(0, n - 1), im(-1, n - 1);
+        return [=]() mutable {
+          (*flx)[0](im+h, i, i) = formulae::donorcell::make_flux<opts, 0>(psi, (*GC)[0], im, i, i);
+          (*flx)[1](i, im+h, i) = formulae::donorcell::make_flux<opts, 1>(psi, (*GC)[1], im, i, i);
+          (*flx)[2](i, i, im+h) = formulae::donorcell::make_flux<opts, 2>(psi, (*GC)[2], im, i, i);
+        };
+      });
+
+      add<3>("donorcell_sum", opts, n, opts::isset(opts, opts::khn) ? 8 : 5, [n]{
+        auto psi = scl<3>(n), psi_new = scl<3>(n), G = scl<3>(n);
+        auto flx = vec<3>(3, n), khn_tmp = vec<3>(3, n);
+        const rng_t i(0, n - 1);
+        const idx_t<3> ijk({i, i, i});
+        return [=]() mutable {
+          formulae::donorcell::donorcell_sum<opts>(
+            *khn_tmp, ijk, psi_new(ijk), psi(ijk),
+            (*flx)[0](i+h, i,   i  ), (*flx)[0](i-h, i,   i  ),
+            (*flx)[1](i,   i+h, i  ), (*flx)[1](i,   i-h, i  ),
+            (*flx)[2](i,   i,   i+h), (*flx)[2](i,   i,   i-h),
+            formulae::G<opts, 0>(G, i, i, i)
+          );
+        };
+      });
+    }
+
+    template <opts_t opts>
+    static void fct(const int n)
+    {
+      add<3>("beta_up_dn", opts, n, 8, [n]{
+        auto psi = scl<3>(n), psi_max = scl<3>(n, 2, 3), psi_min = scl<3>(n, 0, 1), G = scl<3>(n);
+        auto flx = vec<3>(3, n), beta = vec<3>(2, n);
+        const rng_t i1(-1, n);
+        return [=]() mutable {
+          formulae::mpdata::beta_up<opts>((*beta)[0], psi, psi_max, *flx, G, i1, i1, i1);
+          formulae::mpdata::beta_dn<opts>((*beta)[1], psi, psi_min, *flx, G, i1, i1, i1);
+        };
+      });
+
+      add<3>("GC_mono", opts, n, 9, [n]{
+        auto psi = scl<3>(n), G = scl<3>(n);
+        auto beta = vec<3>(2, n, 0, 2), GC_corr = vec<3>(3, n), GC_mono = vec<3>(3, n);
+        const rng_t i(0, n - 1), im(-1, n - 1);
+        return [=]() mutable {
+          formulae::mpdata::GC_mono<opts, 0>(*GC_mono, psi, (*beta)[0], (*beta)[1], *GC_corr, G, im, i, i);
+          formulae::mpdata::GC_mono<opts, 1>(*GC_mono, psi, (*beta)[0], (*beta)[1], *GC_corr, G, im, i, i);
+          formulae::mpdata::GC_mono<opts, 2>(*GC_mono, psi, (*beta)[0], (*beta)[1], *GC_corr, G, im, i, i);
+        };
+      });
+    }
+
+    static void nabla(const int n)
+    {
+      add<3>("calc_grad", 0, n, 4, [n]{
+        auto psi = scl<3>(n);
+        auto v = vec<3>(3, n);
+        const rng_t i(0, n - 1);
+        const idx_t<3> ijk({i, i, i});
+        const std::array<real_t, 3> dijk = {.1, .1, .1};
+        return [=]() mutable {
+          formulae::nabla::calc_grad<3>(*v, psi, ijk, dijk);
+        };
+      });
+
+      add<3>("div", 0, n, 4, [n]{
+        auto div = scl<3>(n);
+        auto v = vec<3>(3, n);
+        const rng_t i(0, n - 1);
+        const idx_t<3> ijk({i, i, i});
+        const std::array<real_t, 3> dijk = {.1, .1, .1};
+        return [=]() mutable {
+          div(ijk) = formulae::nabla::div<3>(*v, ijk, dijk);
+        };
+      });
+    }
+
+    static void stress(const int n)
+    {
+      add<3>("calc_vgrad", 0, n, 12, [n]{
+        auto v = vec<3>(3, n), vg = vec<3>(9, n);
+        const rng_t i(0, n - 1);
+        const idx_t<3> ijk({i, i, i});
+        const std::array<real_t, 3> dijk = {.1, .1, .1};
+        return [=]() mutable {
+          formulae::stress::calc_vgrad<3>(*vg, *v, ijk, dijk);
+        };
+      });
+
+      add<3>("calc_deform", 0, n, 15, [n]{
+        auto vg = vec<3>(9, n), tau = vec<3>(6, n);
+        const rng_t i(0, n - 1);
+        const idx_t<3> ijk({i, i, i});
+        return [=]() mutable {
+          formulae::stress::calc_deform<3>(*tau, *vg, ijk);
+        };
+      });
+
+      add<3>("calc_stress_div", 0, n, 15, [n]{
+        auto tau = vec<3>(6, n), sdiv = vec<3>(9, n);
+        const rng_t i(0, n - 1);
+        const idx_t<3> ijk({i, i, i});
+        const std::array<real_t, 3> dijk = {.1, .1, .1};
+        return [=]() mutable {
+          formulae::stress::calc_stress_div<3>(*sdiv, *tau, ijk, dijk);
+        };
+      });
+    }
+  };
+
+  // all kernels for all the sizes, for the options relevant to each of them
+  template <int n_dims>
+  void sweep(const std::vector<int> &sizes)
+  {
+    using k = kernels<n_dims>;
+    for (const int n : sizes)
+    {
+      k::template antidiff<0>(n);
+      k::template antidiff<opts::abs>(n);
+      k::template antidiff<opts::iga>(n);
+      k::template antidiff<opts::tot>(n);
+      k::template antidiff<opts::iga | opts::tot>(n);
+      k::template antidiff<opts::dfl>(n);
+      k::template antidiff<opts::iga | opts::div_2nd | opts::div_3rd>(n);
+
+      k::template donorcell<0>(n);
+      k::template donorcell<opts::khn>(n);
+
+      k::template fct<opts::fct>(n);
+      k::template fct<opts::fct | opts::abs>(n);
+      k::template fct<opts::fct | opts::iga>(n);
+
+      k::nabla(n);
+      k::stress(n);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  // from fitting in the L1 cache to exceeding the last-level cache
+  sweep<1>({1 << 10, 1 << 16, 1 << 22});
+  sweep<2>({32, 256, 1024});
+  sweep<3>({16, 48, 96});
+
+  return bench::run(argc, argv);
+}
@@ -0,0 +1,256 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief performance regression test: a fixed set of short single-threaded runs whose time per step
+ *   is compared with the baseline stored for the machine (refdata/<fingerprint>.txt, see fingerprint());
+ *   fails if any of the cases is slower than the baseline by more than the threshold
+ *
+ * usage: perf_regression --baseline=<refdata directory> [--output=<directory>] [--threshold=<allowed relative slowdown, default 0.2>]
+ *   the measured times are written to the output directory (in the baseline format), without
+ *   a baseline for the machine the run exits with skip_code
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/solvers/boussinesq.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <thread>
+
+#if defined(__APPLE__)
+#  include <sys/sysctl.h>
+#endif
+
+using namespace libmpdataxx;
+
+namespace
+{
+  // CPU model, number of hardware threads and compiler, as a file name
+  std::string fingerprint()
+  {
+    std::string cpu = "unknown_cpu";
+#if defined(__APPLE__)
+    char buf[256];
+    std::size_t len = sizeof(buf);
+    if (sysctlbyname("machdep.cpu.brand_string", buf, &len, nullptr, 0) == 0) cpu = buf;
+#else
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    for (std::string line; std::getline(cpuinfo, line);)
+    {
+      // "model name" on x86 and recent ARM kernels, "Processor" on older ARM ones
+      if (line.find("model name") == 0 || line.find("Processor") == 0)
+      {
+        cpu = line.substr(line.find(':') + 1);
+        break;
+      }
+    }
+#endif
+
+#if defined(__clang__)
+    const std::string cxx = "clang-" __clang_version__;
+#elif defined(__GNUC__)
+    const std::string cxx = "gcc-" __VERSION__;
+#else
+    const std::string cxx = "unknown_compiler";
+#endif
+
+    std::string res = cpu + "-" + std::to_string(std::thread::hardware_concurrency()) + "t-" + cxx, tmp;
+    for (const char c : res)
+    {
+      const char s = std::isalnum(c) || c == '.' || c == '-' ? c : '_';
+      if (s != '_' || (!tmp.empty() && tmp.back() != '_')) tmp += s;
+    }
+    return tmp;
+  }
+
+  const int n_samples = 5;
+
+  // exit code of a run without a baseline (see SKIP_RETURN_CODE in CMakeLists.txt)
+  const int skip_code = 77;
+
+  // the fastest of n_samples runs of nt steps, after a warm-up step
+  template <class run_t>
+  double time_per_step(run_t &run, const int nt)
+  {
+    run.advance(1);
+    double best = std::numeric_limits<double>::max();
+    for (int s = 0; s < n_samples; ++s)
+    {
+      const auto t0 = std::chrono::steady_clock::now();
+      run.advance(nt);
+      best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() / nt);
+    }
+    return best;
+  }
+
+  // cyclic in all dimensions
+  template <class slv_t, int n_dims> struct serial_cyclic;
+
+  template <class slv_t> struct serial_cyclic<slv_t, 1>
+  {
+    using type = concurr::serial<slv_t, bcond::cyclic, bcond::cyclic>;
+  };
+
+  template <class slv_t> struct serial_cyclic<slv_t, 2>
+  {
+    using type = concurr::serial<slv_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic>;
+  };
+
+  template <class slv_t> struct serial_cyclic<slv_t, 3>
+  {
+    using type = concurr::serial<slv_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic>;
+  };
+
+  template <int n_dims_arg, int opts_arg>
+  double adv(const std::array<int, n_dims_arg> &grid, const int nt)
+  {
+    struct ct_params_t : ct_params_default_t
+    {
+      using real_t = double;
+      enum { n_dims = n_dims_arg };
+      enum { n_eqns = 1 };
+      enum { opts = opts_arg };
+    };
+
+    using slv_t = solvers::mpdata<ct_params_t>;
+    typename slv_t::rt_params_t p;
+    p.grid_size = grid;
+
+    typename serial_cyclic<slv_t, n_dims_arg>::type run(p);
+
+    blitz::firstIndex i;
+    run.advectee() = 1 + exp(-pow(i - grid[0] / 2., 2) / 64.);
+    for (int d = 0; d < n_dims_arg; ++d) run.advector(d) = .5 / (d + 1);
+
+    return time_per_step(run, nt);
+  }
+
+  double bsq_2d(const int nx, const int nt)
+  {
+    struct ct_params_t : ct_params_default_t
+    {
+      using real_t = double;
+      enum { n_dims = 2 };
+      enum { n_eqns = 3 };
+      enum { rhs_scheme = solvers::trapez };
+      enum { prs_scheme = solvers::cr };
+      struct ix { enum {
+        u, w, tht,
+        vip_i=u, vip_j=w, vip_den=-1
+      }; };
+    };
+    using ix = typename ct_params_t::ix;
+
+    using slv_t = solvers::boussinesq<ct_params_t>;
+    typename slv_t::rt_params_t p;
+    p.grid_size = {nx, nx};
+    p.dt = .75;
+    p.di = p.dj = 10;
+    p.Tht_ref = 300;
+    p.prs_tol = 1e-7;
+
+    concurr::serial<slv_t,
+      bcond::cyclic, bcond::cyclic,
+      bcond::rigid, bcond::rigid
+    > run(p);
+
+    blitz::firstIndex i;
+    blitz::secondIndex j;
+    run.advectee(ix::tht) = p.Tht_ref + where(pow(i - nx / 2., 2) + pow(j - nx / 4., 2) <= pow(nx / 8., 2), .5, 0);
+    run.advectee(ix::u) = 0;
+    run.advectee(ix::w) = 0;
+    run.sclr_array("tht_e") = p.Tht_ref;
+
+    return time_per_step(run, nt);
+  }
+}
+
+int main(int argc, char **argv)
+{
+#if defined(USE_MPI)
+  // several solvers are instantiated, MPI must not be finalised by the first one
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+
+  std::string baseline_dir, output_dir;
+  double threshold = .2;
+  for (int a = 1; a < argc; ++a)
+  {
+    const std::string arg = argv[a];
+    if (arg.find("--baseline=") == 0) baseline_dir = arg.substr(11);
+    else if (arg.find("--output=") == 0) output_dir = arg.substr(9);
+    else if (arg.find("--threshold=") == 0) threshold = std::stod(arg.substr(12));
+    else throw std::runtime_error("unknown argument: " + arg);
+  }
+  if (baseline_dir.empty()) throw std::runtime_error("--baseline=<directory> not given");
+
+  // a fixed set of cases, each taking a fraction of a second
+  std::map<std::string, double> times;
+  times["mpdata_1d_iga_fct"]   = adv<1, opts::iga | opts::fct>({4096}, 200);
+  times["mpdata_2d_abs_fct"]   = adv<2, opts::abs | opts::fct>({256, 256}, 10);
+  times["mpdata_2d_iga_tot"]   = adv<2, opts::iga | opts::tot>({256, 256}, 10);
+  times["mpdata_3d_iga_fct"]   = adv<3, opts::iga | opts::fct>({64, 64, 64}, 4);
+  times["boussinesq_2d_cr"]    = bsq_2d(128, 10);
+
+  const std::string fp = fingerprint(), path = baseline_dir + "/" + fp + ".txt";
+  std::cout << "machine fingerprint: " << fp << std::endl;
+
+  std::map<std::string, double> base;
+  {
+    std::ifstream is(path);
+    std::string name;
+    double t;
+    while (is >> name >> t) base[name] = t;
+  }
+
+  if (!output_dir.empty())
+  {
+    boost::filesystem::create_directories(output_dir);
+    const std::string out_path = output_dir + "/" + fp + ".txt";
+    std::ofstream os(out_path);
+    if (!os) throw std::runtime_error("cannot write " + out_path);
+    for (const auto &t : times) os << t.first << " " << t.second << std::endl;
+    std::cout << "measured times written to: " << out_path << std::endl;
+  }
+
+  int status = 0;
+  if (base.empty())
+  {
+    std::cout << "no baseline for this machine in " << baseline_dir << ", skipping the comparison" << std::endl;
+    status = skip_code;
+  }
+  else
+  {
+    for (const auto &t : times)
+    {
+      const auto b = base.find(t.first);
+      if (b == base.end())
+      {
+        std::cout << t.first << ": " << t.second << " s/step (no baseline)" << std::endl;
+        continue;
+      }
+      const double ratio = t.second / b->second;
+      const bool slow = ratio > 1 + threshold;
+      std::cout << t.first << ": " << t.second << " s/step, baseline " << b->second
+                << " (" << (ratio - 1) * 100 << "%)" << (slow ? " SLOWER THAN THRESHOLD" : "") << std::endl;
+      if (slow) status = 1;
+    }
+  }
+
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+  return status;
+}
@@ -0,0 +1,308 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief strong- and weak-scaling runs of a 3D advection case and a 3D Boussinesq (warm bubble) case
+ *   with the serial, openmp, cxx11_thread and boost_thread backends for 1...N threads, writing
+ *   the time per step, the parallel efficiency and the per-phase breakdown (see ct_params_t::phase_timers)
+ *   to a JSON file; with MPI the whole set is run by each process count, see scaling.py
+ *
+ * usage: scaling [--case=adv|bsq|all] [--backend=serial|openmp|cxx11_thread|boost_thread|all]
+ *                [--mode=strong|weak|all] [--threads=<max>] [--nx=<strong-scaling nx>]
+ *                [--nx_per_worker=<weak-scaling nx per thread and process>] [--steps=<n>] [--out=<file>]
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/solvers/boussinesq.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/concurr/openmp.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/concurr/boost_thread.hpp>
+
+#if defined(USE_MPI)
+#  include <mpi.h>
+#endif
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace libmpdataxx;
+
+namespace
+{
+  using phases_t = std::map<std::string, double>;
+
+  struct result_t
+  {
+    std::string case_name, mode, backend;
+    int ranks, threads;
+    std::array<int, 3> grid;
+    int steps;
+    double time_per_step, efficiency;
+    phases_t phases; // average over threads and processes, per step
+  };
+
+  const int n_warm = 2; // steps not timed (first touch of the memory, solver initialisation)
+
+  int mpi_size()
+  {
+    int size = 1;
+#if defined(USE_MPI)
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+    return size;
+  }
+
+  int mpi_rank()
+  {
+    int rank = 0;
+#if defined(USE_MPI)
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+    return rank;
+  }
+
+  // time per step of the slowest process, and the per-step phase timings
+  template <class run_t>
+  double timed(run_t &run, const int nt, phases_t &phases)
+  {
+    run.advance(n_warm);
+    const auto before = run.phase_timings();
+
+    const auto t0 = std::chrono::steady_clock::now();
+    run.advance(nt);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+#if defined(USE_MPI)
+    MPI_Allreduce(MPI_IN_PLACE, &wall, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+    for (const auto &s : run.phase_timings())
+    {
+      const auto b = before.find(s.first);
+      phases[s.first] = (s.second.avg - (b == before.end() ? 0 : b->second.avg)) / nt;
+    }
+    return wall / nt;
+  }
+
+  // advection of a Gaussian blob by a constant oblique flow, cyclic in all dimensions
+  template <template <class, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e> class concurr_t>
+  double adv(const std::array<int, 3> &grid, const int nt, phases_t &phases)
+  {
+    struct ct_params_t : ct_params_default_t
+    {
+      using real_t = double;
+      enum { n_dims = 3 };
+      enum { n_eqns = 1 };
+      enum { opts = opts::iga | opts::fct };
+      enum { phase_timers = true };
+    };
+
+    using slv_t = solvers::mpdata<ct_params_t>;
+    typename slv_t::rt_params_t p;
+    p.grid_size = grid;
+    p.n_iters = 2;
+
+    concurr_t<slv_t,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic
+    > run(p);
+
+    run.advectee_local_set([&](typename slv_t::arr_t psi) {
+      blitz::firstIndex i;
+      blitz::secondIndex j;
+      blitz::thirdIndex k;
+      psi = 1 + exp(-(
+        pow(i - grid[0] / 2., 2) + pow(j - grid[1] / 2., 2) + pow(k - grid[2] / 2., 2)
+      ) / 64.);
+    });
+    run.advector(0) = .5;
+    run.advector(1) = .3;
+    run.advector(2) = .2;
+
+    return timed(run, nt, phases);
+  }
+
+  // a rising warm bubble, cyclic horizontally, rigid lid and bottom
+  template <template <class, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e> class concurr_t>
+  double bsq(const std::array<int, 3> &grid, const int nt, phases_t &phases)
+  {
+    struct ct_params_t : ct_params_default_t
+    {
+      using real_t = double;
+      enum { n_dims = 3 };
+      enum { n_eqns = 4 };
+      enum { rhs_scheme = solvers::trapez };
+      enum { prs_scheme = solvers::cr };
+      enum { phase_timers = true };
+      struct ix { enum {
+        u, v, w, tht,
+        vip_i=u, vip_j=v, vip_k=w, vip_den=-1
+      }; };
+    };
+    using ix = typename ct_params_t::ix;
+
+    using slv_t = solvers::boussinesq<ct_params_t>;
+    typename slv_t::rt_params_t p;
+    p.grid_size = grid;
+    p.n_iters = 2;
+    p.dt = 1;
+    p.di = p.dj = p.dk = 10;
+    p.Tht_ref = 300;
+    p.prs_tol = 1e-6;
+
+    concurr_t<slv_t,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic,
+      bcond::rigid, bcond::rigid
+    > run(p);
+
+    run.advectee_local_set([&](typename slv_t::arr_t tht) {
+      blitz::firstIndex i;
+      blitz::secondIndex j;
+      blitz::thirdIndex k;
+      tht = p.Tht_ref + .5 * exp(-(
+        pow(i - grid[0] / 2., 2) + pow(j - grid[1] / 2., 2) + pow(k - grid[2] / 4., 2)
+      ) / 16.);
+    }, ix::tht);
+    for (const int e : {int(ix::u), int(ix::v), int(ix::w)})
+      run.advectee_local_set([](typename slv_t::arr_t vel) { vel = 0; }, e);
+    run.sclr_array("tht_e") = p.Tht_ref;
+
+    return timed(run, nt, phases);
+  }
+
+  struct args_t
+  {
+    std::string case_name = "all", backend = "all", mode = "all", out = "scaling.json";
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int nx = 128, nx_per_worker = 16, steps = 10;
+  };
+
+  // 1, 2, 4, ... and max
+  std::vector<int> thread_counts(const int max)
+  {
+    std::vector<int> res;
+    for (int n = 1; n < max; n *= 2) res.push_back(n);
+    res.push_back(max);
+    return res;
+  }
+
+  template <template <class, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e, bcond::bcond_e> class concurr_t>
+  void sweep(const args_t &o, const std::string &backend, const int max_threads, std::vector<result_t> &results)
+  {
+    if (o.backend != "all" && o.backend != backend) return;
+
+    for (const std::string case_name : {"adv", "bsq"})
+    {
+      if (o.case_name != "all" && o.case_name != case_name) continue;
+      for (const std::string mode : {"strong", "weak"})
+      {
+        if (o.mode != "all" && o.mode != mode) continue;
+        double t_ref = 0;
+        for (const int n_thrds : thread_counts(max_threads))
+        {
+          // the backends take the number of threads from OMP_NUM_THREADS
+          setenv("OMP_NUM_THREADS", std::to_string(n_thrds).c_str(), 1);
+
+          const int workers = n_thrds * mpi_size();
+          std::array<int, 3> grid = case_name == "adv"
+            ? std::array<int, 3>{o.nx, 64, 64}
+            : std::array<int, 3>{o.nx, 64, 32};
+          if (mode == "weak") grid[0] = o.nx_per_worker * workers;
+
+          result_t r{case_name, mode, backend, mpi_size(), n_thrds, grid, o.steps, 0, 0, {}};
+          r.time_per_step = case_name == "adv"
+            ? adv<concurr_t>(grid, o.steps, r.phases)
+            : bsq<concurr_t>(grid, o.steps, r.phases);
+
+          // relative to the single-thread run with the same number of processes (see scaling.py for across processes)
+          if (n_thrds == 1) t_ref = r.time_per_step;
+          r.efficiency = mode == "strong"
+            ? t_ref / (n_thrds * r.time_per_step)
+            : t_ref / r.time_per_step;
+
+          if (mpi_rank() == 0)
+            std::cerr << "scaling: " << case_name << " " << mode << " " << backend << " ranks=" << r.ranks
+                      << " threads=" << n_thrds << ": " << r.time_per_step << " s/step, efficiency " << r.efficiency << std::endl;
+          results.push_back(r);
+        }
+      }
+    }
+  }
+
+  void write_json(std::ostream &os, const std::vector<result_t> &results)
+  {
+    os << "[" << std::endl;
+    for (std::size_t n = 0; n < results.size(); ++n)
+    {
+      const auto &r = results[n];
+      os << "  {\"case\": \"" << r.case_name << "\", \"mode\": \"" << r.mode << "\", \"backend\": \"" << r.backend
+         << "\", \"ranks\": " << r.ranks << ", \"threads\": " << r.threads
+         << ", \"grid\": [" << r.grid[0] << ", " << r.grid[1] << ", " << r.grid[2] << "]"
+         << ", \"steps\": " << r.steps << ", \"time_per_step\": " << r.time_per_step
+         << ", \"efficiency\": " << r.efficiency << ", \"phases\": {";
+      bool first = true;
+      for (const auto &ph : r.phases)
+      {
+        os << (first ? "" : ", ") << "\"" << ph.first << "\": " << ph.second;
+        first = false;
+      }
+      os << "}}" << (n + 1 < results.size() ? "," : "") << std::endl;
+    }
+    os << "]" << std::endl;
+  }
+}
+
+int main(int argc, char **argv)
+{
+#if defined(USE_MPI)
+  // initialised here so that MPI is not finalised by the first solver (see distmem)
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+#endif
+
+  args_t o;
+  for (int a = 1; a < argc; ++a)
+  {
+    const std::string arg = argv[a];
+    const auto eq = arg.find('=');
+    const std::string key = arg.substr(0, eq), val = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--case") o.case_name = val;
+    else if (key == "--backend") o.backend = val;
+    else if (key == "--mode") o.mode = val;
+    else if (key == "--threads") o.threads = std::stoi(val);
+    else if (key == "--nx") o.nx = std::stoi(val);
+    else if (key == "--nx_per_worker") o.nx_per_worker = std::stoi(val);
+    else if (key == "--steps") o.steps = std::stoi(val);
+    else if (key == "--out") o.out = val;
+    else throw std::runtime_error("unknown argument: " + arg);
+  }
+
+  std::vector<result_t> results;
+  sweep<concurr::serial>(o, "serial", 1, results);
+#if defined(_OPENMP)
+  sweep<concurr::openmp>(o, "openmp", o.threads, results);
+#endif
+  sweep<concurr::cxx11_thread>(o, "cxx11_thread", o.threads, results);
+  sweep<concurr::boost_thread>(o, "boost_thread", o.threads, results);
+
+  if (mpi_rank() == 0)
+  {
+    std::ofstream os(o.out);
+    if (!os) throw std::runtime_error("cannot open " + o.out);
+    write_json(os, results);
+  }
+
+#if defined(USE_MPI)
+  MPI_Finalize();
+#endif
+}
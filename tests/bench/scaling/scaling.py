@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+#
+# runs the scaling benchmark for 1...P MPI processes (1, 2, 4, ..., P) and merges the results,
+# the parallel efficiency being recomputed with respect to 1 process and 1 thread
+#
+# usage: scaling.py <path to the scaling binary> [--np=<P>] [--mpirun=<command>] [--out=<prefix>] [binary arguments]
+#   writes <prefix>.json and <prefix>.csv (one column per phase), with --np=1 the binary is run without mpirun
+
+import json
+import os
+import shlex
+import subprocess
+import sys
+
+binary = sys.argv[1]
+np_max, mpirun, prefix, args = 1, "mpirun", "scaling", []
+for arg in sys.argv[2:]:
+  if arg.startswith("--np="):
+    np_max = int(arg[5:])
+  elif arg.startswith("--mpirun="):
+    mpirun = arg[9:]
+  elif arg.startswith("--out="):
+    prefix = arg[6:]
+  else:
+    args.append(arg)
+
+nps = [1]
+while nps[-1] * 2 < np_max:
+  nps.append(nps[-1] * 2)
+if np_max > 1:
+  nps.append(np_max)
+
+results = []
+for np in nps:
+  out = "%s.np%d.json" % (prefix, np)
+  cmd = ([] if np_max == 1 else shlex.split(mpirun) + ["-np", str(np)]) + [os.path.abspath(binary), "--out=" + out] + args
+  print(" ".join(cmd), file=sys.stderr)
+  subprocess.check_call(cmd)
+  with open(out) as f:
+    results += json.load(f)
+  os.remove(out)
+
+# reference: 1 process and 1 thread of the same case, mode and backend
+ref = {}
+for r in results:
+  if r["ranks"] == 1 and r["threads"] == 1:
+    ref[(r["case"], r["mode"], r["backend"])] = r["time_per_step"]
+for r in results:
+  t_ref = ref.get((r["case"], r["mode"], r["backend"]))
+  if t_ref is None:
+    continue
+  workers = r["ranks"] * r["threads"]
+  r["efficiency"] = t_ref / r["time_per_step"] / (workers if r["mode"] == "strong" else 1)
+
+with open(prefix + ".json", "w") as f:
+  json.dump(results, f, indent=2)
+
+phases = sorted(set(p for r in results for p in r["phases"]))
+cols = ["case", "mode", "backend", "ranks", "threads", "nx", "ny", "nz", "steps", "time_per_step", "efficiency"]
+with open(prefix + ".csv", "w") as f:
+  f.write(",".join(cols + phases) + "\n")
+  for r in results:
+    row = [r["case"], r["mode"], r["backend"], r["ranks"], r["threads"]] + r["grid"] + [r["steps"], r["time_per_step"], r["efficiency"]]
+    row += [r["phases"].get(p, 0) for p in phases]
+    f.write(",".join(str(v) for v in row) + "\n")
@@ -0,0 +1,149 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * benchmark of HDF5 output write time vs. file size for different
+ * chunking, compression, precision-reduction and subsampling settings
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+#include <libmpdata++/output/hdf5.hpp>
+
+#include <boost/filesystem.hpp>
+#include <chrono>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 1 };
+};
+
+const int nx = 128, ny = 128, nz = 64, nt = 20;
+const double dx = 1. / nx, dy = 1. / ny, dz = 1. / nz, cx = .2, cy = .1;
+
+template <class run_t>
+void init(run_t &run)
+{
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+
+  // a smooth but not constant field so that compression ratios are not trivial
+  run.advectee() = 1 + exp(-(pow(i * dx - .5, 2) + pow(j * dy - .5, 2) + pow(k * dz - .5, 2)) / .02)
+                     + 1e-3 * sin(40 * i * dx) * cos(30 * k * dz);
+  run.advector(0) = cx;
+  run.advector(1) = cy;
+  run.advector(2) = 0;
+}
+
+double dir_size(const std::string &dir)
+{
+  namespace fs = boost::filesystem;
+  double size = 0;
+  for (fs::recursive_directory_iterator it(dir), end; it != end; ++it)
+    if (fs::is_regular_file(*it)) size += fs::file_size(*it);
+  return size;
+}
+
+template <class run_t>
+double timed_advance(run_t &run)
+{
+  auto start = std::chrono::steady_clock::now();
+  run.advance(nt);
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void bench(
+  const std::string &label,
+  const output::hdf5_filter_e filter,
+  const int level,
+  const bool shuffle,
+  const std::array<int, 3> chunk,
+  const double t_ref,
+  const int keepbits = 0,
+  const bool pack16 = false,
+  const int stride = 1
+)
+{
+  using slv_out_t = output::hdf5<solvers::mpdata<ct_params_t>>;
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {nx, ny, nz};
+  p.outfreq = 1;
+  p.outdir = "out_" + label;
+  p.outvars = {{0, {"psi", "", keepbits, pack16, {}, {}, {stride, stride, stride}}}};
+  p.hdf5_filter = filter;
+  p.hdf5_filter_level = level;
+  p.hdf5_shuffle = shuffle;
+  p.hdf5_chunk = chunk;
+
+  concurr::threads<
+    slv_out_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > run(p);
+  init(run);
+
+  const double t = timed_advance(run);
+  std::cout
+    << std::setw(24) << label
+    << std::setw(14) << (t - t_ref) / (nt + 1)
+    << std::setw(14) << dir_size(p.outdir) / (nt + 1) / (1 << 20)
+    << std::endl;
+}
+
+int main()
+{
+#if defined(USE_MPI)
+  // we will instantiate many solvers, so we have to init mpi manually,
+  // because solvers will not know should they finalize mpi upon destruction
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+
+  // reference run without output
+  double t_ref;
+  {
+    using slv_t = solvers::mpdata<ct_params_t>;
+    typename slv_t::rt_params_t p;
+    p.grid_size = {nx, ny, nz};
+    concurr::threads<
+      slv_t,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic
+    > run(p);
+    init(run);
+    t_ref = timed_advance(run);
+  }
+
+  std::cout
+    << std::setw(24) << "setting"
+    << std::setw(14) << "s/record"
+    << std::setw(14) << "MiB/record"
+    << std::endl;
+
+  const std::array<int, 3> whole = {}, pencil = {nx, ny, 8};
+
+  bench("none",                 output::hdf5_filter_e::none,     0, false, whole,  t_ref);
+  bench("deflate1",             output::hdf5_filter_e::deflate,  1, false, whole,  t_ref);
+  bench("deflate5",             output::hdf5_filter_e::deflate,  5, false, whole,  t_ref);
+  bench("shuffle_deflate1",     output::hdf5_filter_e::deflate,  1, true,  whole,  t_ref);
+  bench("shuffle_deflate1_z8",  output::hdf5_filter_e::deflate,  1, true,  pencil, t_ref);
+  bench("shuffle_deflate1_kb10", output::hdf5_filter_e::deflate,  1, true,  whole,  t_ref, 10);
+  bench("shuffle_deflate1_i16", output::hdf5_filter_e::deflate,  1, true,  whole,  t_ref, 0,  true);
+  bench("shuffle_deflate1_s2",  output::hdf5_filter_e::deflate,  1, true,  whole,  t_ref, 0,  false, 2);
+  if (H5Zfilter_avail(32004) > 0)
+    bench("shuffle_lz4",          output::hdf5_filter_e::lz4,      0, true,  whole,  t_ref);
+  if (H5Zfilter_avail(32015) > 0)
+    bench("shuffle_zstd3",        output::hdf5_filter_e::zstd,     3, true,  whole,  t_ref);
+
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -6,6 +6,7 @@
  */
 
 #include <cmath>
+#include <chrono>
 #include <boost/math/constants/constants.hpp>
 #include <libmpdata++/solvers/mpdata.hpp>
 #include <libmpdata++/concurr/threads.hpp>
@@ -15,7 +16,7 @@ using T = double;
 using namespace libmpdataxx;
 
 template <int opts_arg, int opts_iters>
-void test(const std::string filename)
+void test(const std::string filename, const std::array<int, 2> &mpi_dims, const bool comm_thread, const bool slab_rebalance, const bool persistent)
 {
   struct ct_params_t : ct_params_default_t
   {
@@ -51,6 +52,22 @@ void test(const std::string filename)
   p.outvars[0].name = "psi";
   p.outdir = "out_2d";
 
+  // process grid, zeros are chosen by MPI (the default is to divide the domain in x only)
+  p.mpi_dims = mpi_dims;
+  for (const auto &n : mpi_dims) p.outdir += "_" + std::to_string(n);
+
+  // all MPI calls done by a dedicated thread
+  p.mpi_comm_thread = comm_thread;
+  if (comm_thread) p.outdir += "_comm_thread";
+
+  // thread subdomains resized between the advance() calls below
+  p.slab_rebalance = slab_rebalance;
+  if (slab_rebalance) p.outdir += "_slab_rebalance";
+
+  // halos exchanged without packing (subarray datatypes and persistent requests)
+  p.mpi_persistent = persistent;
+  if (persistent) p.outdir += "_persistent";
+
   // instantiation
   concurr::threads<
     slv_out_t, 
@@ -91,18 +108,45 @@ void test(const std::string filename)
   run.advector(0) =  dt / dx;
   run.advector(1) =  0;
 
-  run.advance(nt);
+  auto start = std::chrono::steady_clock::now();
+  if (slab_rebalance)
+  {
+    run.advance(nt / 2);
+    run.advance(nt - nt / 2);
+  }
+  else
+    run.advance(nt);
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
   auto L2_error = sqrt(sum(pow(solution - run.advectee_global(), 2)));
   std::cout << "L2 error: " << L2_error << std::endl;
+#if defined(USE_MPI)
+  if (MPI::COMM_WORLD.Get_rank() == 0)
+#endif
+  {
+    // for comparison of the process grids (scaling runs)
+    std::cout << "process grid:";
+    for (const auto &n : mpi_dims) std::cout << " " << n;
+    std::cout << " wall time: " << wall << " s" << std::endl;
+  }
   if(L2_error > 4.82) throw std::runtime_error("L2 error greater than threshold (4.82)");
 }
 
-int main()
+// optional arguments: number of processes in each dimension, e.g. "mpi_adv_2d 2 2",
+// followed by "comm_thread" to use the MPI communication thread, "slab_rebalance" to resize
+// the thread subdomains half way through or "persistent" to use persistent requests
+int main(int argc, char **argv)
 {
+  std::array<int, 2> mpi_dims = concurr::detail::default_mpi_dims<2>();
+  for (int d = 0; d < 2 && d + 1 < argc; ++d)
+    mpi_dims[d] = std::stoi(argv[d + 1]);
+  const bool comm_thread = argc > 3 && std::string(argv[3]) == "comm_thread";
+  const bool slab_rebalance = argc > 3 && std::string(argv[3]) == "slab_rebalance";
+  const bool persistent = argc > 3 && std::string(argv[3]) == "persistent";
+
   {
     enum { opts = 0};
     enum { opts_iters = 1};
-    test<opts, opts_iters>("upwind");
+    test<opts, opts_iters>("upwind", mpi_dims, comm_thread, slab_rebalance, persistent);
   }
 }
@@ -6,6 +6,7 @@
  */
 
 #include <cmath>
+#include <chrono>
 #include <boost/math/constants/constants.hpp>
 #include <libmpdata++/solvers/mpdata.hpp>
 #include <libmpdata++/concurr/threads.hpp>
@@ -15,7 +16,7 @@ using T = double;
 using namespace libmpdataxx;
 
 template <int opts_arg, int opts_iters>
-void test(const std::string filename)
+void test(const std::string filename, const std::array<int, 3> &mpi_dims)
 {
   struct ct_params_t : ct_params_default_t
   {
@@ -53,6 +54,10 @@ void test(const std::string filename)
   p.outvars[0].name = "psi";
   p.outdir = "out_3d";
 
+  // process grid, zeros are chosen by MPI (the default is to divide the domain in x only)
+  p.mpi_dims = mpi_dims;
+  for (const auto &n : mpi_dims) p.outdir += "_" + std::to_string(n);
+
   // instantiation
   concurr::threads<
     slv_out_t, 
@@ -66,22 +71,36 @@ void test(const std::string filename)
   T y0 = 0.5;
   T z0 = 0.5;
 
-  decltype(run.advectee()) r_local(run.advectee().extent());
-  r_local.reindexSelf(run.advectee().lbound());
-
   blitz::firstIndex i;
   blitz::secondIndex j;
   blitz::thirdIndex k;
 
-  r_local = sqrt(blitz::pow(i * dx - x0, 2) + blitz::pow(j * dy - y0, 2) + blitz::pow(k * dz - z0, 2));
-  run.advectee() = where(
-    r_local <= rr,
-    1 + 0.25 * pow(1 + cos(pi * r_local / rr), 2),
-    1.
-  );
+  // each process sets its own part, no global array needed
+  run.advectee_local_set([&](decltype(run.advectee()) psi) {
+    decltype(run.advectee()) r_local(psi.extent());
+    r_local.reindexSelf(psi.lbound());
+    r_local = sqrt(blitz::pow(i * dx - x0, 2) + blitz::pow(j * dy - y0, 2) + blitz::pow(k * dz - z0, 2));
+    psi = where(
+      r_local <= rr,
+      1 + 0.25 * pow(1 + cos(pi * r_local / rr), 2),
+      1.
+    );
+  });
+
+  run.advector(0) =  dt / dx;
+  run.advector(1) =  0;
+  run.advector(2) =  0;
+
+  auto start = std::chrono::steady_clock::now();
+  run.advance(nt);
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // the result gathered on rank 0 only
+  const auto psi = run.advectee_root();
+  if (psi.size() == 0) return;
 
-  decltype(run.advectee()) solution(run.advectee_global().shape());
-  decltype(run.advectee()) r_global(run.advectee_global().shape());
+  decltype(run.advectee()) solution(nx, ny, nz);
+  decltype(run.advectee()) r_global(nx, ny, nz);
 
   T disp = std::fmod(time, 4.0);
   
@@ -92,22 +111,27 @@ void test(const std::string filename)
     1.
   );
 
-  run.advector(0) =  dt / dx;
-  run.advector(1) =  0;
-  run.advector(2) =  0;
+  auto L2_error = sqrt(sum(pow(solution - psi, 2)));
+  std::cout << "L2 error: " << L2_error << std::endl;
 
-  run.advance(nt);
+  // for comparison of the process grids (scaling runs)
+  std::cout << "process grid:";
+  for (const auto &n : mpi_dims) std::cout << " " << n;
+  std::cout << " wall time: " << wall << " s" << std::endl;
 
-  auto L2_error = sqrt(sum(pow(solution - run.advectee_global(), 2)));
-  std::cout << "L2 error: " << L2_error << std::endl;
   if(L2_error > 20.3) throw std::runtime_error("L2 error greater than threshold (20.3)");
 }
 
-int main()
+// optional arguments: number of processes in each dimension, e.g. "mpi_adv_3d 2 2 1"
+int main(int argc, char **argv)
 {
+  std::array<int, 3> mpi_dims = concurr::detail::default_mpi_dims<3>();
+  for (int d = 0; d < 3 && d + 1 < argc; ++d)
+    mpi_dims[d] = std::stoi(argv[d + 1]);
+
   {
     enum { opts = 0};
     enum { opts_iters = 1};
-    test<opts, opts_iters>("upwind");
+    test<opts, opts_iters>("upwind", mpi_dims);
   }
 }
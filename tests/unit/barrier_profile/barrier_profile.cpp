@@ -0,0 +1,52 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief a test for the barrier profile (rt_params_t::barrier_profile)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+
+using namespace libmpdataxx;
+
+int main()
+{
+  struct ct_params_t : ct_params_default_t
+  {
+    using real_t = double;
+    enum { n_dims = 1 };
+    enum { n_eqns = 2 };
+  };
+
+  const int nx = 64, nt = 10;
+
+  using slv_t = solvers::mpdata<ct_params_t>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = {nx};
+  p.barrier_profile = true;
+
+  concurr::threads<slv_t, bcond::cyclic, bcond::cyclic> run(p);
+
+  run.advectee(0) = 1;
+  run.advectee(1) = 2;
+  run.advector() = .5;
+
+  run.advance(nt);
+
+  const auto sites = run.barrier_profile();
+  if (sites.empty()) throw std::runtime_error("no barriers recorded");
+  double per_step = 0;
+  for (const auto &s : sites)
+  {
+    std::cerr << s.site << ": " << s.calls_per_step << " " << s.wait_avg << std::endl;
+    if (!(s.wait_min <= s.wait_avg && s.wait_avg <= s.wait_max)) throw std::runtime_error("inconsistent barrier waiting times");
+    per_step += s.calls_per_step;
+  }
+  // at least the one at the beginning of each timestep and the two in sharedmem::cycle()
+  if (per_step < 3) throw std::runtime_error("too few barriers per timestep");
+  for (std::size_t i = 1; i < sites.size(); ++i)
+    if (sites[i].wait_avg > sites[i - 1].wait_avg) throw std::runtime_error("barrier sites not sorted");
+}
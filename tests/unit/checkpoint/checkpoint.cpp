@@ -0,0 +1,149 @@
+// unit test for checkpoint/restart - continuation after restart (with a different number
+// of threads) has to be bit-identical with an uninterrupted run, and the output continued;
+// covered are plain mpdata and a boussinesq solver (trapezoidal rhs, implicit absorber,
+// pressure solver) whose state includes the rhs, the velocity history and the pressure
+//
+// licensing: GPU GPL v3
+// copyright: University of Warsaw
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/solvers/boussinesq.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/concurr/openmp.hpp>
+#include <libmpdata++/output/hdf5_xdmf.hpp>
+
+#include <fstream>
+
+using namespace libmpdataxx;
+
+const int nx = 32, ny = 24, nt = 10;
+
+struct ct_params_adv_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+  enum { opts = opts::iga | opts::fct };
+};
+
+struct ct_params_bsnq_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 3 };
+  enum { rhs_scheme = solvers::trapez };
+  enum { vip_vab = solvers::impl };
+  enum { prs_scheme = solvers::cr };
+  enum { impl_tht = true };
+  struct ix { enum {
+    u, w, tht,
+    vip_i=u, vip_j=w, vip_den=-1
+  }; };
+};
+
+using adv_t = output::hdf5_xdmf<solvers::mpdata<ct_params_adv_t>>;
+using bsnq_t = output::hdf5_xdmf<solvers::boussinesq<ct_params_bsnq_t>>;
+
+void set_params(adv_t::rt_params_t &)
+{}
+
+void set_params(bsnq_t::rt_params_t &p)
+{
+  p.outvars = {{ct_params_bsnq_t::ix::tht, {"tht", "K"}}};
+  p.dt = 1;
+  p.di = p.dj = 10;
+  p.prs_tol = 1e-7;
+  p.Tht_ref = 300;
+}
+
+template <class solver_t>
+typename solver_t::rt_params_t params(const std::string &suffix)
+{
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+  p.n_iters = 2;
+  p.outfreq = nt / 2;
+  p.outdir = boost::filesystem::unique_path().native() + suffix;
+  set_params(p);
+  return p;
+}
+
+template <class concurr_t>
+void setup(concurr_t &run, adv_t *)
+{
+  run.advectee() = exp(
+    -pow(blitz::tensor::i - nx / 2., 2) / 20
+    -pow(blitz::tensor::j - ny / 2., 2) / 20
+  );
+  run.advector(0) = .3;
+  run.advector(1) = -.2;
+}
+
+template <class concurr_t>
+void setup(concurr_t &run, bsnq_t *)
+{
+  using ix = ct_params_bsnq_t::ix;
+  run.advectee(ix::tht) = .5 * exp(
+    -pow(blitz::tensor::i - nx / 2., 2) / 20
+    -pow(blitz::tensor::j - ny / 3., 2) / 20
+  );
+  run.advectee(ix::u) = 0;
+  run.advectee(ix::w) = 0;
+
+  // fields set by the user, restored from the checkpoint
+  run.sclr_array("tht_e") = 300 + .01 * blitz::tensor::j;
+  run.sclr_array("tht_abs") = where(blitz::tensor::j > 3 * ny / 4, .01, 0);
+  run.vab_coefficient() = where(blitz::tensor::j > 3 * ny / 4, .01, 0);
+  run.vab_relaxed_state(0) = 0;
+  run.vab_relaxed_state(1) = 0;
+}
+
+template <class solver_t, bcond::bcond_e bcy>
+void test()
+{
+  // uninterrupted run
+  concurr::openmp<solver_t, bcond::cyclic, bcond::cyclic, bcy, bcy> ref(params<solver_t>("_ref"));
+  setup(ref, (solver_t*)nullptr);
+  ref.advance(nt);
+
+  // checkpoint in the middle of the run
+  const std::string ckpt = boost::filesystem::unique_path().native() + ".h5";
+  const auto p = params<solver_t>("_ckpt");
+  {
+    concurr::openmp<solver_t, bcond::cyclic, bcond::cyclic, bcy, bcy> run(p);
+    setup(run, (solver_t*)nullptr);
+    run.advance(nt / 2);
+    run.checkpoint(ckpt);
+  }
+
+  // restart with a single thread, writing to the same output directory
+  concurr::serial<solver_t, bcond::cyclic, bcond::cyclic, bcy, bcy> run(p);
+  run.restart(ckpt);
+  run.advance(nt / 2);
+
+  if (run.time() != ref.time())
+    throw std::runtime_error("time differs after restart");
+  for (int e = 0; e < solver_t::n_eqns; ++e)
+    if (any(run.advectee_global(e) != ref.advectee_global(e)))
+      throw std::runtime_error("state differs after restart");
+
+  // the temporal collection has to list the timesteps written before and after the restart
+  std::ifstream xmf(p.outdir + "/temp.xmf");
+  int n_entries = 0;
+  for (std::string line; std::getline(xmf, line);)
+    if (line.find("xi:include") != std::string::npos) ++n_entries;
+  if (n_entries != 3)
+    throw std::runtime_error("temporal collection not continued after restart");
+}
+
+int main()
+{
+#if defined(USE_MPI)
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+  test<adv_t, bcond::cyclic>();
+  test<bsnq_t, bcond::rigid>();
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -0,0 +1,153 @@
+// unit test for the lossy hdf5 output options: a known field, including non-finite values,
+// written with keepbits and with pack16 and read back with HDF5
+//
+// licensing: GPU GPL v3
+// copyright: University of Warsaw
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/openmp.hpp>
+#include <libmpdata++/output/hdf5.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace libmpdataxx;
+
+const int nx = 16, ny = 8, keepbits = 7;
+
+void check(const std::string &msg, const bool cond)
+{
+  if (!cond) throw std::runtime_error(msg);
+}
+
+// bit tests, as std::isnan() and std::isinf() may be optimised away with -ffast-math
+std::uint32_t to_bits(const float x)
+{
+  std::uint32_t b;
+  std::memcpy(&b, &x, sizeof(b));
+  return b;
+}
+
+bool is_finite(const double x)
+{
+  std::uint64_t b;
+  std::memcpy(&b, &x, sizeof(b));
+  return (b & 0x7ff0000000000000ULL) != 0x7ff0000000000000ULL;
+}
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 2 };
+};
+
+using solver_t = output::hdf5<solvers::mpdata<ct_params_t>>;
+using run_t = concurr::openmp<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic>;
+
+int main()
+{
+#if defined(USE_MPI)
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+  {
+    solver_t::rt_params_t p;
+    p.grid_size = {nx, ny};
+    p.outdir = boost::filesystem::unique_path().native();
+    p.outvars = {
+      {0, {"kb", "", keepbits}},
+      {1, {"pk", "", 0, true}}
+    };
+
+    // values of both signs spanning several orders of magnitude, and a NaN and infinities
+    blitz::Array<double, 2> ref(nx, ny);
+    ref = (blitz::tensor::i - 7.3) * pow(10., blitz::tensor::j - 3.);
+    ref(3, 2) = std::numeric_limits<double>::quiet_NaN();
+    ref(10, 5) = std::numeric_limits<double>::infinity();
+    ref(12, 1) = -std::numeric_limits<double>::infinity();
+
+    run_t run(p);
+    run.advector(0) = 0;
+    run.advector(1) = 0;
+    run.advectee_global_set(ref, 0);
+    run.advectee_global_set(ref, 1);
+    run.advance(0); // only the initial record
+
+    H5::H5File f(p.outdir + "/timestep0000000000.h5", H5F_ACC_RDONLY);
+
+    // keepbits: relative error of at most 2^-keepbits, NaN and infinities unchanged
+    {
+      blitz::Array<float, 2> kb(nx, ny);
+      f.openDataSet("kb").read(kb.data(), H5::PredType::NATIVE_FLOAT);
+      for (int i = 0; i < nx; ++i)
+        for (int j = 0; j < ny; ++j)
+        {
+          const std::uint32_t b = to_bits(kb(i, j));
+          if (i == 3 && j == 2)
+            check("keepbits: NaN", (b & 0x7f800000) == 0x7f800000 && (b & 0x007fffff) != 0);
+          else if (i == 10 && j == 5)
+            check("keepbits: +Inf", b == to_bits(std::numeric_limits<float>::infinity()));
+          else if (i == 12 && j == 1)
+            check("keepbits: -Inf", b == to_bits(-std::numeric_limits<float>::infinity()));
+          else
+          {
+            check("keepbits: relative error", std::abs(kb(i, j) - ref(i, j)) <= std::ldexp(std::abs(ref(i, j)), -keepbits));
+            check("keepbits: mantissa not rounded", (b & ((1u << (23 - keepbits)) - 1)) == 0);
+          }
+        }
+    }
+
+    // pack16: values reconstructed from scale_factor and add_offset within half a quantum,
+    // non-finite values stored as _FillValue
+    {
+      const auto dset = f.openDataSet("pk");
+      float scale_factor, add_offset;
+      short fill_value;
+      dset.openAttribute("scale_factor").read(H5::PredType::NATIVE_FLOAT, &scale_factor);
+      dset.openAttribute("add_offset").read(H5::PredType::NATIVE_FLOAT, &add_offset);
+      dset.openAttribute("_FillValue").read(H5::PredType::NATIVE_SHORT, &fill_value);
+      check("pack16: scale_factor", scale_factor > 0);
+
+      blitz::Array<short, 2> pk(nx, ny);
+      dset.read(pk.data(), H5::PredType::NATIVE_SHORT);
+      for (int i = 0; i < nx; ++i)
+        for (int j = 0; j < ny; ++j)
+        {
+          if (!is_finite(ref(i, j)))
+            check("pack16: non-finite value not stored as _FillValue", pk(i, j) == fill_value);
+          else
+          {
+            check("pack16: _FillValue used for a finite value", pk(i, j) != fill_value);
+            const double val = pk(i, j) * double(scale_factor) + add_offset;
+            check("pack16: error above half a quantum", std::abs(val - ref(i, j)) <= .5 * scale_factor * (1 + 1e-6));
+          }
+        }
+    }
+  }
+
+  // keepbits and pack16 are exclusive
+  {
+    solver_t::rt_params_t p;
+    p.grid_size = {nx, ny};
+    p.outdir = boost::filesystem::unique_path().native();
+    p.outvars = {
+      {0, {"kb", "", keepbits, true}},
+      {1, {"pk", "", 0, true}}
+    };
+
+    bool thrown = false;
+    try
+    {
+      run_t run(p);
+    }
+    catch (const std::runtime_error &)
+    {
+      thrown = true;
+    }
+    check("keepbits together with pack16 not rejected", thrown);
+  }
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -0,0 +1,129 @@
+// unit test for the hdf5 output regions (info_t::start, count and stride): with several threads,
+// strides not dividing the thread subdomains and non-zero starts, the regions read back have to
+// match the subsampled advectee, and their XDMF descriptors have to give the region shapes
+//
+// licensing: GPU GPL v3
+// copyright: University of Warsaw
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/hdf5_xdmf.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace libmpdataxx;
+
+const int nx = 23, ny = 9, nt = 4, n_threads = 3;
+const double di = .5, dj = 2;
+
+void check(const std::string &msg, const bool cond)
+{
+  if (!cond) throw std::runtime_error(msg);
+}
+
+// value of the Dimensions attribute of the first element following the given text
+std::string dimensions_after(const std::string &xmf, const std::string &what)
+{
+  const std::string attr = "Dimensions=\"";
+  const auto pos = xmf.find(what);
+  check("not in the XDMF file: " + what, pos != std::string::npos);
+  const auto beg = xmf.find(attr, pos) + attr.size();
+  return xmf.substr(beg, xmf.find('"', beg) - beg);
+}
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 2 };
+};
+
+using solver_t = output::hdf5_xdmf<solvers::mpdata<ct_params_t>>;
+
+int main()
+{
+#if defined(USE_MPI)
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+  setenv("OMP_NUM_THREADS", std::to_string(n_threads).c_str(), 1);
+  {
+    // regions: a from (2, 1) to the domain end with strides (3, 2),
+    // b from (1, 0) with counts (4, 0) and strides (5, 1)
+    const std::array<std::array<int, 2>, 2>
+      start  = {{{2, 1}, {1, 0}}},
+      stride = {{{3, 2}, {5, 1}}},
+      count  = {{{(nx - 2 - 1) / 3 + 1, (ny - 1 - 1) / 2 + 1}, {4, ny}}};
+
+    solver_t::rt_params_t p;
+    p.grid_size = {nx, ny};
+    p.di = di;
+    p.dj = dj;
+    p.outfreq = nt;
+    p.outdir = boost::filesystem::unique_path().native();
+    p.outvars = {
+      {0, {"a", "", 0, false, start[0], {}, stride[0]}},
+      {1, {"b", "", 0, false, start[1], {4, 0}, stride[1]}}
+    };
+
+    concurr::cxx11_thread<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> run(p);
+
+    run.advector(0) = .3;
+    run.advector(1) = -.2;
+    run.advectee(0) = blitz::tensor::i + 100 * blitz::tensor::j;
+    run.advectee(1) = exp(-pow(blitz::tensor::i - nx / 2., 2) / 10 - pow(blitz::tensor::j - ny / 2., 2) / 5);
+    run.advance(nt);
+
+    H5::H5File f(p.outdir + "/timestep0000000004.h5", H5F_ACC_RDONLY);
+    H5::H5File c(p.outdir + "/const.h5", H5F_ACC_RDONLY);
+
+    for (int e = 0; e < 2; ++e)
+    {
+      const std::string name = e == 0 ? "a" : "b", roi = "roi" + std::to_string(e);
+      const int cx = count[e][0], cy = count[e][1];
+
+      // data: the subsampled advectee
+      const auto dset = f.openDataSet(name);
+      hsize_t dims[2];
+      dset.getSpace().getSimpleExtentDims(dims);
+      check(name + ": dataset shape", int(dims[0]) == cx && int(dims[1]) == cy);
+
+      blitz::Array<float, 2> out(cx, cy);
+      dset.read(out.data(), H5::PredType::NATIVE_FLOAT);
+
+      const blitz::Array<double, 2> psi(run.advectee_global(e));
+      blitz::Array<float, 2> expected(cx, cy);
+      expected = blitz::cast<float>(psi(
+        blitz::Range(start[e][0], start[e][0] + (cx - 1) * stride[e][0], stride[e][0]),
+        blitz::Range(start[e][1], start[e][1] + (cy - 1) * stride[e][1], stride[e][1])
+      ));
+      check(name + ": values", all(out == expected));
+
+      // coordinates: edges of the coarse cells, the last one not exceeding the domain
+      blitz::Array<float, 2> x(cx + 1, cy + 1), y(cx + 1, cy + 1);
+      c.openDataSet("X_" + roi).read(x.data(), H5::PredType::NATIVE_FLOAT);
+      c.openDataSet("Y_" + roi).read(y.data(), H5::PredType::NATIVE_FLOAT);
+      for (int i = 0; i <= cx; ++i)
+        for (int j = 0; j <= cy; ++j)
+        {
+          check(name + ": X", x(i, j) == float(di * std::min(start[e][0] + i * stride[e][0], nx)));
+          check(name + ": Y", y(i, j) == float(dj * std::min(start[e][1] + j * stride[e][1], ny)));
+        }
+
+      // XDMF: cell-centered attribute of the region shape on a mesh with one more point in each dimension
+      std::ifstream ifs(p.outdir + "/timestep0000000004_" + roi + ".xmf");
+      std::stringstream xmf;
+      xmf << ifs.rdbuf();
+      const std::string
+        cells = std::to_string(cx) + " " + std::to_string(cy) + " ",
+        pnts = std::to_string(cx + 1) + " " + std::to_string(cy + 1) + " ";
+      check(name + ": XDMF attribute dimensions", dimensions_after(xmf.str(), "Name=\"" + name + "\"") == cells);
+      check(name + ": XDMF topology dimensions", dimensions_after(xmf.str(), "<Topology") == pnts);
+      check(name + ": XDMF geometry dimensions", dimensions_after(xmf.str(), "<Geometry") == pnts);
+    }
+  }
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -0,0 +1,85 @@
+// unit test for the in-situ horizontal statistics (vertical profiles) written to stats.h5
+//
+// licensing: GPU GPL v3
+// copyright: University of Warsaw
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/openmp.hpp>
+#include <libmpdata++/output/hdf5.hpp>
+
+using namespace libmpdataxx;
+
+const int nx = 16, nz = 8, nt = 2;
+
+void check(const std::string &msg, const bool cond)
+{
+  if (!cond) throw std::runtime_error(msg);
+}
+
+int main()
+{
+#if defined(USE_MPI)
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+  {
+    struct ct_params_t : ct_params_default_t
+    {
+      using real_t = double;
+      enum { n_dims = 2 };
+      enum { n_eqns = 1 };
+    };
+
+    using solver_t = output::hdf5<solvers::mpdata<ct_params_t>>;
+
+    solver_t::rt_params_t p;
+    p.grid_size = {nx, nz};
+    p.outfreq = nt;
+    p.outdir = boost::filesystem::unique_path().native();
+    p.outstats = {
+      {"psi_mean", output::stat_mean, 0},
+      {"psi_var",  output::stat_var,  0},
+      {"psi_cov",  output::stat_cov,  0, 0},
+      {"psi_min",  output::stat_min,  0},
+      {"psi_max",  output::stat_max,  0}
+    };
+
+    concurr::openmp<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> run(p);
+
+    // no advection, the field stays as initialised
+    run.advector(0) = 0;
+    run.advector(1) = 0;
+    run.advectee() = blitz::tensor::i + 10 * blitz::tensor::j;
+    run.advance(nt);
+
+    // checking the profiles
+    H5::H5File f(p.outdir + "/stats.h5", H5F_ACC_RDONLY);
+    hsize_t dims[2];
+    f.openDataSet("psi_mean").getSpace().getSimpleExtentDims(dims);
+    check("number of records", dims[0] == nt + 1 && dims[1] == nz);
+
+    blitz::Array<double, 2> prof(nt + 1, nz);
+    blitz::Array<double, 1> expected(nz);
+    const double eps = 1e-10;
+
+    f.openDataSet("psi_mean").read(prof.data(), H5::PredType::NATIVE_DOUBLE);
+    expected = (nx - 1) / 2. + 10 * blitz::tensor::i;
+    for (int t = 0; t <= nt; ++t) check("mean", max(abs(prof(t, blitz::Range::all()) - expected)) < eps);
+
+    for (const std::string name : {"psi_var", "psi_cov"})
+    {
+      f.openDataSet(name).read(prof.data(), H5::PredType::NATIVE_DOUBLE);
+      check(name, max(abs(prof - (nx * nx - 1) / 12.)) < eps);
+    }
+
+    f.openDataSet("psi_min").read(prof.data(), H5::PredType::NATIVE_DOUBLE);
+    expected = 10 * blitz::tensor::i;
+    for (int t = 0; t <= nt; ++t) check("min", max(abs(prof(t, blitz::Range::all()) - expected)) < eps);
+
+    f.openDataSet("psi_max").read(prof.data(), H5::PredType::NATIVE_DOUBLE);
+    expected = nx - 1 + 10 * blitz::tensor::i;
+    for (int t = 0; t <= nt; ++t) check("max", max(abs(prof(t, blitz::Range::all()) - expected)) < eps);
+  }
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
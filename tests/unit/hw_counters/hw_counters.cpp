@@ -0,0 +1,52 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief a test for the hardware counters of the timed regions (rt_params_t::hw_counters),
+ *   not available e.g. in containers (NaN then)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+
+#include <cmath>
+
+using namespace libmpdataxx;
+
+int main()
+{
+  struct ct_params_t : ct_params_default_t
+  {
+    using real_t = double;
+    enum { n_dims = 1 };
+    enum { n_eqns = 2 };
+    enum { phase_timers = true };
+  };
+
+  const int nx = 64, nt = 2;
+
+  using slv_t = solvers::mpdata<ct_params_t>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = {nx};
+  p.hw_counters = true;
+
+  concurr::threads<slv_t, bcond::cyclic, bcond::cyclic> run(p);
+
+  run.advectee(0) = 1;
+  run.advectee(1) = 2;
+  run.advector() = .5;
+
+  run.advance(nt);
+
+  const auto counts = run.hw_counts();
+  bool antidiff = false;
+  for (const auto &c : counts)
+  {
+    if (c.path == "solve_loop_body/advop/antidiff") antidiff = true;
+    for (const auto n : c.counts)
+      if (!std::isnan(n) && n < 0) throw std::runtime_error("negative hardware count");
+  }
+  if (!antidiff) throw std::runtime_error("no hardware counts of antidiff");
+}
@@ -0,0 +1,63 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief a test for the memory accounting (concurr::any::memory_usage, rt_params_t::memory_report)
+ *   and the dry-run estimate (concurr::estimate_memory)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+
+using namespace libmpdataxx;
+
+int main()
+{
+  struct ct_params_t : ct_params_default_t
+  {
+    using real_t = double;
+    enum { n_dims = 2 };
+    enum { n_eqns = 2 };
+    enum { opts = opts::khn };
+  };
+
+  const int nx = 32, ny = 16;
+
+  using slv_t = solvers::mpdata<ct_params_t>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+  p.memory_report = true;
+
+  // estimated before the solver; with MPI, this initialises MPI, which is then finalised by the solver
+  const auto estimate = concurr::estimate_memory<slv_t>(p);
+
+  concurr::serial<slv_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> run(p);
+  const auto stats = run.memory_usage();
+
+  if (estimate.size() != stats.size()) throw std::runtime_error("estimate with a different number of components");
+  for (std::size_t i = 0; i < stats.size(); ++i)
+  {
+    std::cerr << stats[i].file << " " << stats[i].purpose << ": " << stats[i].bytes << " " << stats[i].bytes_max << " " << stats[i].arrays << std::endl;
+    if (
+      estimate[i].file != stats[i].file || estimate[i].purpose != stats[i].purpose ||
+      estimate[i].bytes != stats[i].bytes || estimate[i].arrays != stats[i].arrays
+    ) throw std::runtime_error("estimate differs from the allocated memory");
+    if (stats[i].bytes_max > stats[i].bytes) throw std::runtime_error("more in a process than in total");
+    if (i > 0 && stats[i].bytes > stats[i - 1].bytes) throw std::runtime_error("components not sorted");
+  }
+
+  auto find = [&](const std::string &purpose) {
+    for (const auto &s : stats) if (s.purpose == purpose) return s;
+    throw std::runtime_error("not accounted for: " + purpose);
+  };
+
+  // all time levels of all equations, with halos
+  const auto psi = find("psi");
+  if (psi.arrays != slv_t::n_eqns * slv_t::n_tlev) throw std::runtime_error("wrong number of psi arrays");
+  if (psi.bytes < double(psi.arrays) * nx * ny * sizeof(double)) throw std::runtime_error("psi smaller than the domain");
+
+  if (find("GC").arrays != 2) throw std::runtime_error("wrong number of GC arrays");
+  if (find("khn_tmp").arrays != 3) throw std::runtime_error("wrong number of khn_tmp arrays");
+}
@@ -0,0 +1,58 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief a test for the per-phase timers (ct_params_t::phase_timers)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+
+using namespace libmpdataxx;
+
+int main()
+{
+  struct ct_params_t : ct_params_default_t
+  {
+    using real_t = double;
+    enum { n_dims = 1 };
+    enum { n_eqns = 2 };
+    enum { phase_timers = true };
+  };
+
+  const int nx = 64, nt = 10;
+
+  using slv_t = solvers::mpdata<ct_params_t>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = {nx};
+
+  concurr::threads<slv_t, bcond::cyclic, bcond::cyclic> run(p);
+
+  run.advectee(0) = 1;
+  run.advectee(1) = 2;
+  run.advector() = .5;
+
+  run.advance(nt);
+
+  const auto stats = run.phase_timings();
+  for (const auto &s : stats)
+    std::cerr << s.first << ": " << s.second.min << " / " << s.second.avg << " / " << s.second.max << " (" << s.second.count << ")" << std::endl;
+
+  for (const auto path : {"solve_loop_body", "solve_loop_body/advop", "solve_loop_body/xchng_sclr"})
+    if (stats.count(path) == 0) throw std::runtime_error(std::string("region not timed: ") + path);
+
+  const auto &step = stats.at("solve_loop_body"), &advop = stats.at("solve_loop_body/advop");
+
+  // once per timestep in each thread, advop once per equation
+  if (step.count == 0 || step.count % nt != 0) throw std::runtime_error("wrong number of timesteps");
+  if (advop.count != ct_params_t::n_eqns * step.count) throw std::runtime_error("wrong number of advop calls");
+
+  for (const auto &s : stats)
+    if (!(0 <= s.second.min && s.second.min <= s.second.avg && s.second.avg <= s.second.max))
+      throw std::runtime_error("inconsistent min/avg/max");
+
+  // nested regions do not take longer than the enclosing ones
+  if (advop.max > step.max) throw std::runtime_error("advop longer than the whole step");
+}
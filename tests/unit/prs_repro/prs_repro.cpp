@@ -0,0 +1,99 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * with prs_repro set, the pressure solver has to give bitwise identical fields
+ * whatever the number of threads (and of processes, see CMakeLists.txt)
+ */
+
+#include <libmpdata++/solvers/mpdata_rhs_vip_prs.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 2 };
+  enum { rhs_scheme = solvers::trapez };
+  enum { prs_scheme = solvers::cr };
+  enum { prs_repro = true };
+  struct ix { enum {
+    u, w,
+    vip_i=u, vip_j=w, vip_den=-1
+  }; };
+};
+
+using ix = ct_params_t::ix;
+using slv_t = solvers::mpdata_rhs_vip_prs<ct_params_t>;
+
+const int nx = 60, ny = 20, nt = 10;
+
+std::array<blitz::Array<double, 2>, 2> run(const int n_threads)
+{
+  setenv("OMP_NUM_THREADS", std::to_string(n_threads).c_str(), 1);
+
+  slv_t::rt_params_t p;
+  p.dt = .1;
+  p.di = p.dj = 1;
+  p.prs_tol = 1e-10;
+  p.grid_size = {nx, ny};
+
+  concurr::cxx11_thread<
+    slv_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  // a divergent flow for the pressure solver to work on
+  const double pi = std::acos(-1.);
+  slv.advectee(ix::u) = .5 + .3 * sin(2 * pi * blitz::tensor::i / nx) * cos(2 * pi * blitz::tensor::j / ny);
+  slv.advectee(ix::w) = .2 + .3 * cos(4 * pi * blitz::tensor::i / nx) * sin(2 * pi * blitz::tensor::j / ny);
+
+  slv.advance(nt);
+
+  return {{slv.advectee_global(ix::u).copy(), slv.advectee_global(ix::w).copy()}};
+}
+
+// optional argument: file to which the fields are written (by rank 0),
+// to be compared with those obtained with another number of processes
+int main(int argc, char **argv)
+{
+#if defined(USE_MPI)
+  // we will instantiate many solvers, so we have to init mpi manually,
+  // because solvers will not know should they finalize mpi upon destruction
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+  const auto ref = run(1);
+  for (int n_threads : {2, 3, 5})
+  {
+    const auto res = run(n_threads);
+    for (int e = 0; e < 2; ++e)
+      if (any(res[e] != ref[e]))
+        throw std::runtime_error("fields differ with " + std::to_string(n_threads) + " threads");
+  }
+
+  if (argc > 1)
+  {
+    int rank = 0;
+#if defined(USE_MPI)
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+    if (rank == 0)
+    {
+      std::ofstream out(argv[1], std::ios::binary);
+      for (const auto &arr : ref)
+        out.write(reinterpret_cast<const char*>(arr.data()), arr.size() * sizeof(double));
+    }
+  }
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -0,0 +1,111 @@
+// unit test for the raw memory-mapped output: file size and [time][x][y] layout of the records,
+// also with the files grown and remapped by subsequent advance() calls
+//
+// licensing: GPU GPL v3
+// copyright: University of Warsaw
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/openmp.hpp>
+#include <libmpdata++/output/raw_mmap.hpp>
+
+#include <fstream>
+
+using namespace libmpdataxx;
+
+const int nx = 12, ny = 10, nt = 4, outfreq = 2;
+
+int main()
+{
+#if defined(USE_MPI)
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+  {
+    struct ct_params_t : ct_params_default_t
+    {
+      using real_t = double;
+      enum { n_dims = 2 };
+      enum { n_eqns = 1 };
+    };
+
+    using solver_t = output::raw_mmap<solvers::mpdata<ct_params_t>>;
+
+    solver_t::rt_params_t p;
+    p.grid_size = {nx, ny};
+    p.outfreq = outfreq;
+    p.outdir = boost::filesystem::unique_path().native();
+
+    concurr::openmp<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> run(p);
+
+    // no advection, all records are the same
+    run.advector(0) = 0;
+    run.advector(1) = 0;
+    run.advectee() = blitz::tensor::i + 100 * blitz::tensor::j;
+    run.advance(nt);
+
+    const int n_rec = nt / outfreq + 1;
+    std::ifstream ifs(p.outdir + "/psi.bin", std::ios::binary);
+    std::vector<float> data(n_rec * nx * ny);
+    ifs.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float));
+    if (!ifs || ifs.peek() != EOF) throw std::runtime_error("unexpected size of psi.bin");
+
+    for (int r = 0; r < n_rec; ++r)
+      for (int i = 0; i < nx; ++i)
+        for (int j = 0; j < ny; ++j)
+          if (data[(r * nx + i) * ny + j] != i + 100 * j)
+            throw std::runtime_error("unexpected value in psi.bin");
+
+    if (!boost::filesystem::exists(p.outdir + "/raw.xmf")) throw std::runtime_error("raw.xmf not found");
+  }
+
+  // two variables and a second advance() writing more records than anticipated at start,
+  // hence the files grown and remapped
+  {
+    struct ct_params_t : ct_params_default_t
+    {
+      using real_t = double;
+      enum { n_dims = 2 };
+      enum { n_eqns = 2 };
+    };
+
+    using solver_t = output::raw_mmap<solvers::mpdata<ct_params_t>>;
+
+    solver_t::rt_params_t p;
+    p.grid_size = {nx, ny};
+    p.outfreq = outfreq;
+    p.outvars = {{0, {"a", ""}}, {1, {"b", ""}}};
+    p.outdir = boost::filesystem::unique_path().native();
+
+    concurr::openmp<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> run(p);
+
+    run.advector(0) = 0;
+    run.advector(1) = 0;
+    run.advectee(0) = blitz::tensor::i + 100 * blitz::tensor::j;
+    run.advectee(1) = -1 - blitz::tensor::i - 100 * blitz::tensor::j;
+    run.advance(nt);
+    run.advance(nt);
+
+    // nt / outfreq + 1 records anticipated, doubled when exceeded
+    const int n_rec = 2 * (nt / outfreq) + 1, n_rec_file = 2 * (nt / outfreq + 1);
+    for (const auto &v : p.outvars)
+    {
+      const std::string path = p.outdir + "/" + v.second.name + ".bin";
+      if (boost::filesystem::file_size(path) != n_rec_file * nx * ny * sizeof(float))
+        throw std::runtime_error("unexpected size of " + path);
+
+      std::ifstream ifs(path, std::ios::binary);
+      std::vector<float> data(n_rec * nx * ny);
+      ifs.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float));
+      if (!ifs) throw std::runtime_error("cannot read " + path);
+
+      const float sign = v.first == 0 ? 1 : -1, shift = v.first == 0 ? 0 : -1;
+      for (int r = 0; r < n_rec; ++r)
+        for (int i = 0; i < nx; ++i)
+          for (int j = 0; j < ny; ++j)
+            if (data[(r * nx + i) * ny + j] != shift + sign * (i + 100 * j))
+              throw std::runtime_error("unexpected value in " + path);
+    }
+  }
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
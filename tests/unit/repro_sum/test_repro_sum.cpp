@@ -0,0 +1,107 @@
+#include <libmpdata++/concurr/detail/repro_sum.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace libmpdataxx::concurr::detail;
+
+// sum of values split into n_parts chunks (as if done by n_parts threads or processes),
+// the partial sums added in reverse order
+double split_sum(const std::vector<double> &v, const double max_abs, const int n_parts)
+{
+  std::vector<repro_sum<>> parts(n_parts, repro_sum<>(max_abs, v.size()));
+  for (std::size_t i = 0; i < v.size(); ++i)
+    parts[i * n_parts / v.size()].add(v[i]);
+  repro_sum<> res(max_abs, v.size());
+  for (int p = n_parts - 1; p >= 0; --p) res.add(parts[p].acc);
+  return res.result();
+}
+
+// (std::isnan() may be optimised away with -ffast-math used in Release builds)
+bool is_nan(const double x)
+{
+  std::uint64_t b;
+  std::memcpy(&b, &x, sizeof(b));
+  return (b & 0x7ff0000000000000ULL) == 0x7ff0000000000000ULL && (b & 0x000fffffffffffffULL) != 0;
+}
+
+int main()
+{
+  const int n = 1 << 20;
+  std::mt19937 gen(44);
+  std::uniform_real_distribution<double> mant(-1, 1);
+  std::uniform_int_distribution<int> expo(-20, 20);
+
+  // values of both signs spanning a wide range of magnitudes
+  std::vector<double> v(n);
+  for (auto &x : v) x = std::ldexp(mant(gen), expo(gen));
+  double max_abs = 0;
+  for (const auto &x : v) max_abs = std::max(max_abs, std::abs(x));
+
+  long double exact = 0;
+  for (const auto &x : v) exact += x;
+
+  std::cerr << std::setprecision(20);
+
+  // plain sums differ depending on the decomposition and order...
+  std::vector<double> w(v);
+  std::shuffle(w.begin(), w.end(), gen);
+  const double plain = std::accumulate(v.begin(), v.end(), 0.),
+               plain_shuffled = std::accumulate(w.begin(), w.end(), 0.);
+  std::cerr << "plain sum:         " << plain << " (shuffled: " << plain_shuffled << ")" << std::endl;
+
+  // ... reproducible ones do not
+  const double ref = split_sum(v, max_abs, 1);
+  std::cerr << "reproducible sum:  " << ref << std::endl;
+  std::cerr << "exact:             " << double(exact) << std::endl;
+  for (int n_parts : {2, 3, 7, 64, 1000})
+  {
+    if (split_sum(v, max_abs, n_parts) != ref) throw std::runtime_error("A");
+    if (split_sum(w, max_abs, n_parts) != ref) throw std::runtime_error("B");
+  }
+
+  // and are accurate
+  if (std::abs(ref - double(exact)) > 1e-12 * std::abs(double(exact))) throw std::runtime_error("C");
+
+  // all zeros
+  if (split_sum(std::vector<double>(10, 0.), 0, 3) != 0) throw std::runtime_error("D");
+
+  // tiny values
+  if (split_sum(std::vector<double>(4, 1e-300), 1e-300, 3) != 4e-300) throw std::runtime_error("E");
+
+  // non-finite values propagated as in plain summation (whatever the bound)
+  const double inf = std::numeric_limits<double>::infinity(), nan = std::numeric_limits<double>::quiet_NaN();
+  for (double max_abs : {2., inf, nan})
+  {
+    if (!is_nan(split_sum({1, nan, 2}, max_abs, 2))) throw std::runtime_error("F");
+    if (split_sum({1, inf, 2}, max_abs, 2) != inf) throw std::runtime_error("G");
+    if (split_sum({1, -inf, 2}, max_abs, 2) != -inf) throw std::runtime_error("H");
+    if (!is_nan(split_sum({inf, 1, -inf}, max_abs, 2))) throw std::runtime_error("I");
+  }
+
+  // values not below the bound are rejected
+  bool thrown = false;
+  try { split_sum({1, 4}, 2, 1); } catch (const std::runtime_error &) { thrown = true; }
+  if (!thrown) throw std::runtime_error("J");
+
+  // cost compared to a plain sum
+  const int reps = 20;
+  auto t0 = std::chrono::steady_clock::now();
+  double chk = 0;
+  for (int r = 0; r < reps; ++r) chk += std::accumulate(v.begin(), v.end(), 0.);
+  auto t1 = std::chrono::steady_clock::now();
+  for (int r = 0; r < reps; ++r) chk += split_sum(v, max_abs, 1);
+  auto t2 = std::chrono::steady_clock::now();
+  std::cerr << "time per element, plain: " << std::chrono::duration<double, std::nano>(t1 - t0).count() / reps / n << " ns"
+            << ", reproducible: " << std::chrono::duration<double, std::nano>(t2 - t1).count() / reps / n << " ns"
+            << " (" << chk << ")" << std::endl;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * slab rebalancing on the shared-memory backends: with extra work in the left part
+ * of the domain, the first thread subdomain has to shrink after the first advance()
+ * and the results have to stay bitwise identical to those of a run without rebalancing
+ */
+
+#include <libmpdata++/concurr/openmp.hpp>
+#include <libmpdata++/concurr/boost_thread.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/solvers/mpdata.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+
+using namespace libmpdataxx;
+
+const int nx = 64, ny = 16, nt = 20, n_threads = 4;
+
+// thread subdomain lengths seen during the last time step, and results of the extra work
+std::vector<int> slab_len(n_threads);
+std::vector<double> sink(n_threads);
+
+template <class ct_params_t>
+class heavy_left : public solvers::mpdata<ct_params_t>
+{
+  using parent_t = solvers::mpdata<ct_params_t>;
+
+  public:
+
+  using parent_t::parent_t;
+
+  protected:
+
+  void hook_post_step() override
+  {
+    parent_t::hook_post_step();
+    slab_len[this->rank] = this->ijk[0].length();
+
+    // work on the left quarter of the domain only
+    double x = 0;
+    for (int c = this->ijk[0].first(); c <= std::min(this->ijk[0].last(), nx / 4 - 1); ++c)
+      for (int k = 0; k < 20000; ++k) x += std::sqrt(double(c + k));
+    sink[this->rank] += x;
+  }
+};
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+  enum { opts = opts::iga | opts::fct };
+};
+
+using slv_t = heavy_left<ct_params_t>;
+
+template <template <class, bcond::bcond_e...> class concurr_t>
+void test(const std::string &name)
+{
+  std::cerr << name << " run" << std::endl;
+
+  auto run = [](const bool rebalance, std::vector<int> &first_len) {
+    slv_t::rt_params_t p;
+    p.grid_size = {nx, ny};
+    p.n_iters = 2;
+    p.slab_rebalance = rebalance;
+
+    concurr_t<slv_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> slv(p);
+    slv.advectee() = exp(
+      -pow(blitz::tensor::i - nx / 2., 2) / 20
+      -pow(blitz::tensor::j - ny / 2., 2) / 10
+    );
+    slv.advector(0) = .4;
+    slv.advector(1) = -.3;
+
+    std::vector<int> len_before;
+    for (int a = 0; a < 3; ++a)
+    {
+      slv.advance(nt);
+      if (a == 0) len_before = slab_len;
+    }
+    first_len = {len_before[0], slab_len[0]};
+
+    return blitz::Array<double, 2>(slv.advectee().copy());
+  };
+
+  std::vector<int> len_ref, len;
+  const auto ref = run(false, len_ref);
+  const auto res = run(true, len);
+
+  if (len_ref[0] != len_ref[1])
+    throw std::runtime_error(name + ": subdomains changed without slab_rebalance");
+  if (!(len[1] < len[0]))
+    throw std::runtime_error(name + ": first subdomain not shrunk by slab_rebalance");
+  if (any(res != ref))
+    throw std::runtime_error(name + ": results changed by slab_rebalance");
+}
+
+int main()
+{
+#if defined(USE_MPI)
+  // we will instantiate many solvers, so we have to init mpi manually,
+  // because solvers will not know should they finalize mpi upon destruction
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+  setenv("OMP_NUM_THREADS", std::to_string(n_threads).c_str(), 1);
+
+#if defined(_OPENMP)
+  test<concurr::openmp>("OpenMP");
+#endif
+  test<concurr::boost_thread>("Boost.Thread");
+  test<concurr::cxx11_thread>("C++11 threads");
+
+  std::cerr << "(" << std::accumulate(sink.begin(), sink.end(), 0.) << ")" << std::endl;
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -0,0 +1,49 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief a test for the timeline of the run (rt_params_t::trace_path)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace libmpdataxx;
+
+int main()
+{
+  struct ct_params_t : ct_params_default_t
+  {
+    using real_t = double;
+    enum { n_dims = 1 };
+    enum { n_eqns = 2 };
+    enum { tracing = true };
+  };
+
+  const int nx = 64, nt = 2;
+
+  using slv_t = solvers::mpdata<ct_params_t>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = {nx};
+  p.trace_path = "trace.json";
+
+  // timeline written when the solver is destroyed
+  {
+    concurr::threads<slv_t, bcond::cyclic, bcond::cyclic> run(p);
+    run.advectee(0) = 1;
+    run.advectee(1) = 2;
+    run.advector() = .5;
+    run.advance(nt);
+  }
+
+  std::ifstream f(p.trace_path);
+  std::stringstream trace;
+  trace << f.rdbuf();
+  for (const auto event : {"\"traceEvents\"", "\"name\":\"advop\"", "\"name\":\"xchng_sclr\"", "\"name\":\"barrier\""})
+    if (trace.str().find(event) == std::string::npos) throw std::runtime_error(std::string("not in the timeline: ") + event);
+}